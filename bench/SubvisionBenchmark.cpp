@@ -0,0 +1,219 @@
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <benchmark/benchmark.h>
+#include "../include/constants.h"
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/sheet_detection.h"
+#include "../include/target_detection.h"
+#include "../include/utils.h"
+#include "../test/AllocationCounter.h"
+
+namespace fs = std::filesystem;
+
+const std::string BENCH_RESOURCES_PATH = (fs::current_path() / "resources").string();
+
+namespace {
+    // Allocations par appel, reportées en compteurs du benchmark
+    class AllocationScope {
+    public:
+        explicit AllocationScope(benchmark::State &state) : state(state), start(AllocationSnapshot::now()) {
+        }
+
+        ~AllocationScope() {
+            const AllocationSnapshot allocations = AllocationSnapshot::now().since(start);
+            const auto perCall = benchmark::Counter::kAvgIterations;
+            state.counters["heap_allocs"] = benchmark::Counter(
+                static_cast<double>(allocations.heapAllocations), perCall);
+            state.counters["heap_bytes"] = benchmark::Counter(
+                static_cast<double>(allocations.heapBytes), perCall, benchmark::Counter::kIs1024);
+            state.counters["mat_allocs"] = benchmark::Counter(
+                static_cast<double>(allocations.matAllocations), perCall);
+            state.counters["mat_bytes"] = benchmark::Counter(
+                static_cast<double>(allocations.matBytes), perCall, benchmark::Counter::kIs1024);
+        }
+
+    private:
+        benchmark::State &state;
+        const AllocationSnapshot start;
+    };
+
+    void setThroughput(benchmark::State &state, const cv::Mat &input) {
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.total() * input.elemSize()));
+    }
+
+    struct BenchCase {
+        std::string name;
+        // Photo brute (vide si le cas n'en fournit pas)
+        cv::Mat image;
+        // Feuille recadrée à la résolution de travail
+        cv::Mat sheet;
+    };
+
+    std::vector<BenchCase> loadCases() {
+        std::vector<BenchCase> cases;
+        if (!fs::exists(BENCH_RESOURCES_PATH)) {
+            return cases;
+        }
+
+        for (const auto &entry: fs::directory_iterator(BENCH_RESOURCES_PATH)) {
+            if (!entry.is_directory()) {
+                continue;
+            }
+            const std::string folder = entry.path().filename().string();
+            if (folder == "TODO" || folder.find("WIP") != std::string::npos) {
+                continue;
+            }
+
+            BenchCase benchCase;
+            benchCase.name = folder;
+            benchCase.image = cv::imread((entry.path() / "image.jpg").string());
+            benchCase.sheet = cv::imread((entry.path() / "cropped_sheet.jpg").string());
+            if (benchCase.sheet.empty()) {
+                continue;
+            }
+            cv::resize(benchCase.sheet, benchCase.sheet,
+                       cv::Size(subvision::PICTURE_WIDTH_SHEET_DETECTION, subvision::PICTURE_HEIGHT_SHEET_DETECTION));
+            cases.push_back(std::move(benchCase));
+        }
+        return cases;
+    }
+
+    const std::map<int, std::string> ZONE_NAMES = {
+        {subvision::SUBVISION_ZONE_TOP_LEFT, "top_left"},
+        {subvision::SUBVISION_ZONE_TOP_RIGHT, "top_right"},
+        {subvision::SUBVISION_ZONE_CENTER, "center"},
+        {subvision::SUBVISION_ZONE_BOTTOM_LEFT, "bottom_left"},
+        {subvision::SUBVISION_ZONE_BOTTOM_RIGHT, "bottom_right"}
+    };
+
+    void BM_GetSheetCoordinates(benchmark::State &state, const BenchCase &benchCase) {
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::getSheetCoordinates(benchCase.image));
+        }
+        setThroughput(state, benchCase.image);
+    }
+
+    void BM_GetSheetPicture(benchmark::State &state, const BenchCase &benchCase) {
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::getSheetPicture(benchCase.image));
+        }
+        setThroughput(state, benchCase.image);
+    }
+
+    void BM_GetImpactsMask(benchmark::State &state, const BenchCase &benchCase) {
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::getImpactsMask(benchCase.sheet));
+        }
+        setThroughput(state, benchCase.sheet);
+    }
+
+    void BM_GetImpactsCoordinates(benchmark::State &state, const BenchCase &benchCase) {
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::getImpactsCoordinates(benchCase.sheet));
+        }
+        setThroughput(state, benchCase.sheet);
+    }
+
+    void BM_GetTargetEllipse(benchmark::State &state, const BenchCase &benchCase, const int zone,
+                             const subvision::TargetDetectionMode mode) {
+        const subvision::SheetAnalysis analysis = subvision::analyzeSheet(benchCase.sheet);
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::getTargetEllipseForZone(analysis, zone, mode));
+        }
+        setThroughput(state, subvision::getTargetView(benchCase.sheet, zone));
+    }
+
+    void BM_DrawTargets(benchmark::State &state, const BenchCase &benchCase) {
+        const std::map<int, subvision::Ellipse> ellipses = subvision::targetCoordinatesToSheetCoordinates(
+            subvision::getTargetsEllipse(benchCase.sheet));
+        cv::Mat canvas = benchCase.sheet.clone();
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            subvision::drawTargets(ellipses, canvas);
+            benchmark::ClobberMemory();
+        }
+        setThroughput(state, canvas);
+    }
+
+    void BM_RetrieveImpacts(benchmark::State &state, const BenchCase &benchCase) {
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            subvision::ImpactResults results;
+            benchmark::DoNotOptimize(subvision::retrieveImpacts(benchCase.image, results));
+        }
+        setThroughput(state, benchCase.image);
+    }
+
+    // Contexte réutilisé : après le premier appel, mat_allocs ne compte plus que les allocations internes d'OpenCV
+    void BM_RetrieveImpactsWithContext(benchmark::State &state, const BenchCase &benchCase) {
+        subvision::ProcessingContext context;
+        context.reserve();
+        subvision::ImpactResults results;
+        const subvision::ProcessingOptions options;
+        subvision::retrieveImpacts(benchCase.image, results, options, context);
+
+        AllocationScope allocations(state);
+        for (auto _: state) {
+            benchmark::DoNotOptimize(subvision::retrieveImpacts(benchCase.image, results, options, context));
+        }
+        setThroughput(state, benchCase.image);
+    }
+
+    void registerBenchmarks(const std::vector<BenchCase> &cases) {
+        for (const BenchCase &benchCase: cases) {
+            const std::string suffix = "/" + benchCase.name;
+
+            if (!benchCase.image.empty()) {
+                benchmark::RegisterBenchmark(("getSheetCoordinates" + suffix).c_str(),
+                                             BM_GetSheetCoordinates, benchCase);
+                benchmark::RegisterBenchmark(("getSheetPicture" + suffix).c_str(),
+                                             BM_GetSheetPicture, benchCase);
+                benchmark::RegisterBenchmark(("retrieveImpacts" + suffix).c_str(),
+                                             BM_RetrieveImpacts, benchCase);
+                benchmark::RegisterBenchmark(("retrieveImpactsWithContext" + suffix).c_str(),
+                                             BM_RetrieveImpactsWithContext, benchCase);
+            }
+
+            benchmark::RegisterBenchmark(("getImpactsMask" + suffix).c_str(), BM_GetImpactsMask, benchCase);
+            benchmark::RegisterBenchmark(("getImpactsCoordinates" + suffix).c_str(),
+                                         BM_GetImpactsCoordinates, benchCase);
+
+            for (const auto &[zone, zoneName]: ZONE_NAMES) {
+                benchmark::RegisterBenchmark(("getTargetEllipse" + suffix + "/" + zoneName).c_str(),
+                                             BM_GetTargetEllipse, benchCase, zone,
+                                             subvision::TargetDetectionMode::FULL_RESOLUTION);
+                benchmark::RegisterBenchmark(("getTargetEllipsePyramid" + suffix + "/" + zoneName).c_str(),
+                                             BM_GetTargetEllipse, benchCase, zone,
+                                             subvision::TargetDetectionMode::PYRAMID);
+            }
+
+            benchmark::RegisterBenchmark(("drawTargets" + suffix).c_str(), BM_DrawTargets, benchCase);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    cv::Mat::setDefaultAllocator(getCountingMatAllocator());
+
+    // Les cas doivent survivre à l'exécution des benchmarks enregistrés
+    static const std::vector<BenchCase> cases = loadCases();
+    registerBenchmarks(cases);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,12 +1,50 @@
 #include "include/types.h"
+#include "include/image_buffer.h"
 #include "include/impact_detection.h"
+#include "include/result.h"
 #include "include/sheet_detection.h"
 #include <msclr/marshal_cppstd.h>
+#include <cstdint>
+#include <vector>
 
 using namespace System;
 using namespace System::Collections::Generic;
 using namespace System::Runtime::InteropServices;
 
+namespace {
+    // Size in bytes of a contiguous image, 0 for an invalid size (computed in 64 bits to avoid overflows)
+    uint64_t GetImageByteCount(int width, int height, subvision::PixelFormat format) {
+        if (width <= 0 || height <= 0) {
+            return 0;
+        }
+        const uint64_t area = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+        switch (format) {
+            case subvision::PixelFormat::RGBA:
+                return area * 4;
+            case subvision::PixelFormat::BGR:
+                return area * 3;
+            default:
+                return area * 3 / 2;
+        }
+    }
+
+    // Describe the managed pixels copied in data, INVALID_IMAGE when the array is smaller than the image or when the
+    // size or format is invalid: no exception is thrown into the CLR and no pixel is read past the array
+    subvision::Result<subvision::ImageBuffer> DescribeImage(subvision::PixelFormat format, int width, int height,
+                                                           const std::vector<unsigned char>& data) {
+        const uint64_t required = GetImageByteCount(width, height, format);
+        if (required != 0 && static_cast<uint64_t>(data.size()) < required) {
+            return subvision::Unexpected(subvision::ProcessingError{
+                subvision::ErrorCode::INVALID_IMAGE, -1, "Image data is smaller than the image size"
+            });
+        }
+        if (subvision::isYuvFormat(format)) {
+            return subvision::tryMakeContiguousYuvImageBuffer(format, width, height, data.data());
+        }
+        return subvision::tryMakePackedImageBuffer(format, width, height, data.data());
+    }
+}
+
 namespace SubvisionNET {
 
     // .NET representation of Impact
@@ -39,17 +77,135 @@ namespace SubvisionNET {
         }
     };
 
+    // YUV 4:2:0 layouts accepted by ProcessYuvImage (contiguous buffer)
+    public enum class YuvFormat {
+        NV12,
+        NV21,
+        I420
+    };
+
+    // Annotation returned by the Process* methods
+    public enum class AnnotationMode {
+        // Targets and impacts drawn on the sheet image
+        Raster,
+        // Unmodified sheet image and a list of overlay primitives
+        Vector,
+        // Scores only, no image
+        None
+    };
+
+    // Side of the warped sheet: Fast (800), Balanced (1200) or Precise (2000, default)
+    public enum class ResolutionProfile {
+        Fast,
+        Balanced,
+        Precise
+    };
+
+    // Encoding of the annotated image done by the core
+    public enum class ImageEncoding {
+        None,
+        Jpeg,
+        WebP,
+        Png
+    };
+
+    public ref class EncodingOptions {
+    public:
+        property ImageEncoding Format;
+        // Largest side of the encoded image in pixels, 0 keeps the sheet size of the resolution profile
+        property int MaxDimension;
+        // JPEG/WebP quality (1-100), ignored for PNG
+        property int Quality;
+        // Also return the raw RGBA image
+        property bool KeepImage;
+
+        EncodingOptions() {
+            Format = ImageEncoding::Jpeg;
+            MaxDimension = 0;
+            Quality = 90;
+            KeepImage = false;
+        }
+    };
+
+    public enum class OverlayPrimitiveType {
+        Ellipse,
+        Line,
+        Point,
+        Label
+    };
+
+    // Overlay primitive in sheet coordinates (ImpactResults::SheetSize pixels per side)
+    public ref class OverlayPrimitive {
+    public:
+        property OverlayPrimitiveType Type;
+        // Center (ellipse, point), start (line) or bottom-left corner of the text (label)
+        property float X;
+        property float Y;
+        // End of a line
+        property float X2;
+        property float Y2;
+        // Ellipse semi-axes and angle in degrees
+        property float RadiusX;
+        property float RadiusY;
+        property float Angle;
+        // Point radius or label font scale
+        property float Size;
+        // Stroke width, -1 for a filled point
+        property int Thickness;
+        property int Red;
+        property int Green;
+        property int Blue;
+        property String^ Text;
+    };
+
+    // Processing failure reported in ImpactResults::Error (same order as subvision::ErrorCode)
+    public enum class ErrorCode {
+        None,
+        InvalidImage,
+        NoSheet,
+        DegenerateHomography,
+        InvalidTargetEllipse,
+        EncodingFailed,
+        Internal
+    };
+
+    // Target ellipse in sheet coordinates (full axes, angle in degrees)
+    public ref class TargetEllipse {
+    public:
+        property int Zone;
+        property float X;
+        property float Y;
+        property float Width;
+        property float Height;
+        property float Angle;
+    };
+
     // .NET representation of Impact Results
     public ref class ImpactResults {
     public:
+        // Side of the warped sheet of the resolution profile (2000 for Precise): targets and overlay coordinates
+        property int SheetSize;
         property array<unsigned char>^ AnnotatedImageData;
         property int Width;
         property int Height;
         property int Channels;
+        // Encoded annotated image (EncodingOptions), null when no encoding was requested
+        property array<unsigned char>^ EncodedImageData;
         property List<Impact^>^ Impacts;
+        property List<TargetEllipse^>^ Targets;
+        // Filled in AnnotationMode::Vector only
+        property List<OverlayPrimitive^>^ Overlay;
+        // ErrorCode::None on success, ErrorZone is the failing target zone or -1
+        property ErrorCode Error;
+        property int ErrorZone;
+        property String^ ErrorMessage;
 
         ImpactResults() {
+            Error = ErrorCode::None;
+            ErrorZone = -1;
             Impacts = gcnew List<Impact^>();
+            Targets = gcnew List<TargetEllipse^>();
+            Overlay = gcnew List<OverlayPrimitive^>();
         }
     };
 
@@ -61,23 +217,192 @@ namespace SubvisionNET {
         // width: image width
         // height: image height
         static ImpactResults^ ProcessTargetImage(array<unsigned char>^ imageData, int width, int height) {
+            return ProcessTargetImage(imageData, width, height, AnnotationMode::Raster);
+        }
+
+        // Process target image with the given annotation mode
+        static ImpactResults^ ProcessTargetImage(array<unsigned char>^ imageData, int width, int height,
+                                                 AnnotationMode annotationMode) {
+            return ProcessTargetImage(imageData, width, height, annotationMode, nullptr);
+        }
+
+        // Process target image, the annotated image is encoded by the core when encoding is set
+        static ImpactResults^ ProcessTargetImage(array<unsigned char>^ imageData, int width, int height,
+                                                 AnnotationMode annotationMode, EncodingOptions^ encoding) {
+            return ProcessTargetImage(imageData, width, height, annotationMode, encoding, ResolutionProfile::Precise);
+        }
+
+        // Process target image on the sheet size of the resolution profile
+        static ImpactResults^ ProcessTargetImage(array<unsigned char>^ imageData, int width, int height,
+                                                 AnnotationMode annotationMode, EncodingOptions^ encoding,
+                                                 ResolutionProfile resolution) {
+            // Convert managed array to native vector
+            std::vector<unsigned char> nativeData(imageData->Length);
+            Marshal::Copy((array<unsigned char>^)imageData, 0, IntPtr(nativeData.data()), imageData->Length);
+
+            // Describe the RGBA data, only the warped sheet is converted to BGR by the core
+            const subvision::Result<subvision::ImageBuffer> image = DescribeImage(
+                subvision::PixelFormat::RGBA, width, height, nativeData);
+            return ProcessImage(image, ToProcessingOptions(annotationMode, encoding, resolution));
+        }
+
+        // Process a camera frame in YUV 4:2:0 format
+        // imageData: Y plane followed by the chroma plane(s), without padding
+        // width: image width (even)
+        // height: image height (even)
+        // format: chroma layout
+        static ImpactResults^ ProcessYuvImage(array<unsigned char>^ imageData, int width, int height, YuvFormat format) {
+            return ProcessYuvImage(imageData, width, height, format, AnnotationMode::Raster);
+        }
+
+        // Process a camera frame in YUV 4:2:0 format with the given annotation mode
+        static ImpactResults^ ProcessYuvImage(array<unsigned char>^ imageData, int width, int height, YuvFormat format,
+                                              AnnotationMode annotationMode) {
+            return ProcessYuvImage(imageData, width, height, format, annotationMode, nullptr);
+        }
+
+        // Process a camera frame in YUV 4:2:0 format, the annotated image is encoded by the core when encoding is set
+        static ImpactResults^ ProcessYuvImage(array<unsigned char>^ imageData, int width, int height, YuvFormat format,
+                                              AnnotationMode annotationMode, EncodingOptions^ encoding) {
+            return ProcessYuvImage(imageData, width, height, format, annotationMode, encoding,
+                                   ResolutionProfile::Precise);
+        }
+
+        // Process a camera frame in YUV 4:2:0 format on the sheet size of the resolution profile
+        static ImpactResults^ ProcessYuvImage(array<unsigned char>^ imageData, int width, int height, YuvFormat format,
+                                              AnnotationMode annotationMode, EncodingOptions^ encoding,
+                                              ResolutionProfile resolution) {
+            // Convert managed array to native vector
+            std::vector<unsigned char> nativeData(imageData->Length);
+            Marshal::Copy((array<unsigned char>^)imageData, 0, IntPtr(nativeData.data()), imageData->Length);
+
+            const subvision::Result<subvision::ImageBuffer> image = DescribeImage(
+                ToPixelFormat(format), width, height, nativeData);
+            return ProcessImage(image, ToProcessingOptions(annotationMode, encoding, resolution));
+        }
+
+        // Get sheet coordinates from image
+        // imageData: RGBA image data as byte array
+        // width: image width
+        // height: image height
+        static List<Point2f^>^ GetSheetCoordinates(array<unsigned char>^ imageData, int width, int height) {
             // Convert managed array to native vector
             std::vector<unsigned char> nativeData(imageData->Length);
             Marshal::Copy((array<unsigned char>^)imageData, 0, IntPtr(nativeData.data()), imageData->Length);
 
-            // Create OpenCV Mat from the data (RGBA format)
-            cv::Mat mat(height, width, CV_8UC4, nativeData.data());
-            cv::Mat bgrMat;
-            cv::cvtColor(mat, bgrMat, cv::COLOR_RGBA2BGR);
+            // Describe the RGBA data, the sheet is detected without color conversion
+            const subvision::Result<subvision::ImageBuffer> image = DescribeImage(
+                subvision::PixelFormat::RGBA, width, height, nativeData);
+
+            // An empty list is returned when the image is invalid or when no sheet is found
+            List<Point2f^>^ managedPoints = gcnew List<Point2f^>();
+            if (!image.has_value()) {
+                return managedPoints;
+            }
+            subvision::ProcessingContext context;
+            const auto nativePoints = subvision::tryGetSheetCoordinates(*image, context);
 
-            // Call native function
+            // Convert to managed list
+            if (nativePoints.has_value()) {
+                for (const auto& pt : nativePoints.value()) {
+                    managedPoints->Add(gcnew Point2f(pt.x, pt.y));
+                }
+            }
+
+            return managedPoints;
+        }
+
+    private:
+        // Call native function on a described image, errors (including an invalid image) are returned in the results
+        static ImpactResults^ ProcessImage(const subvision::Result<subvision::ImageBuffer>& image,
+                                           const subvision::ProcessingOptions& options) {
             subvision::ImpactResults nativeResults;
-            bool success = subvision::retrieveImpacts(bgrMat, nativeResults);
+            ImpactResults^ managedResults;
+            if (!image.has_value()) {
+                nativeResults.error = image.error();
+                managedResults = ToManagedResults(nativeResults, false);
+            } else {
+                subvision::ProcessingContext context;
+                const subvision::Status status = subvision::tryRetrieveImpacts(*image, nativeResults, options, context);
+                managedResults = ToManagedResults(nativeResults, status.has_value());
+            }
+            managedResults->SheetSize = subvision::getProcessingProfile(options.resolution).sheetSize;
+            return managedResults;
+        }
 
-            // Convert results to managed types
+        static subvision::PixelFormat ToPixelFormat(YuvFormat format) {
+            switch (format) {
+                case YuvFormat::NV21:
+                    return subvision::PixelFormat::NV21;
+                case YuvFormat::I420:
+                    return subvision::PixelFormat::I420;
+                default:
+                    return subvision::PixelFormat::NV12;
+            }
+        }
+
+        static subvision::ProcessingOptions ToProcessingOptions(AnnotationMode annotationMode,
+                                                                EncodingOptions^ encoding,
+                                                                ResolutionProfile resolution) {
+            subvision::ProcessingOptions options;
+            switch (resolution) {
+                case ResolutionProfile::Fast:
+                    options.resolution = subvision::ResolutionProfile::FAST;
+                    break;
+                case ResolutionProfile::Balanced:
+                    options.resolution = subvision::ResolutionProfile::BALANCED;
+                    break;
+                default:
+                    options.resolution = subvision::ResolutionProfile::PRECISE;
+                    break;
+            }
+            if (encoding != nullptr) {
+                options.encoding.format = static_cast<subvision::ImageEncoding>(static_cast<int>(encoding->Format));
+                options.encoding.maxDimension = encoding->MaxDimension;
+                options.encoding.quality = encoding->Quality;
+                options.encoding.keepImage = encoding->KeepImage;
+            }
+            switch (annotationMode) {
+                case AnnotationMode::Vector:
+                    options.annotationMode = subvision::AnnotationMode::VECTOR;
+                    break;
+                case AnnotationMode::None:
+                    options.annotationMode = subvision::AnnotationMode::NONE;
+                    break;
+                default:
+                    options.annotationMode = subvision::AnnotationMode::RASTER;
+                    break;
+            }
+            return options;
+        }
+
+        static OverlayPrimitive^ ToManagedPrimitive(const subvision::OverlayPrimitive& primitive) {
+            OverlayPrimitive^ managedPrimitive = gcnew OverlayPrimitive();
+            managedPrimitive->Type = static_cast<OverlayPrimitiveType>(static_cast<int>(primitive.type));
+            managedPrimitive->X = primitive.position.x;
+            managedPrimitive->Y = primitive.position.y;
+            managedPrimitive->X2 = primitive.end.x;
+            managedPrimitive->Y2 = primitive.end.y;
+            managedPrimitive->RadiusX = primitive.axes.width;
+            managedPrimitive->RadiusY = primitive.axes.height;
+            managedPrimitive->Angle = primitive.angle;
+            managedPrimitive->Size = primitive.size;
+            managedPrimitive->Thickness = primitive.thickness;
+            managedPrimitive->Red = static_cast<int>(primitive.color[2]);
+            managedPrimitive->Green = static_cast<int>(primitive.color[1]);
+            managedPrimitive->Blue = static_cast<int>(primitive.color[0]);
+            managedPrimitive->Text = msclr::interop::marshal_as<String^>(primitive.text);
+            return managedPrimitive;
+        }
+
+        // Convert native results to managed types
+        static ImpactResults^ ToManagedResults(const subvision::ImpactResults& nativeResults, bool success) {
             ImpactResults^ managedResults = gcnew ImpactResults();
+            managedResults->Error = static_cast<ErrorCode>(static_cast<int>(nativeResults.error.code));
+            managedResults->ErrorZone = nativeResults.error.zone;
+            managedResults->ErrorMessage = msclr::interop::marshal_as<String^>(nativeResults.error.message);
 
-            if (success) {
+            if (success && !nativeResults.annotatedImage.empty()) {
                 // Convert annotated image back to RGBA
                 cv::Mat annotatedRGBA;
                 cv::cvtColor(nativeResults.annotatedImage, annotatedRGBA, cv::COLOR_BGR2RGBA);
@@ -89,7 +414,16 @@ namespace SubvisionNET {
                 managedResults->Width = annotatedRGBA.cols;
                 managedResults->Height = annotatedRGBA.rows;
                 managedResults->Channels = annotatedRGBA.channels();
+            }
+
+            if (success && !nativeResults.encodedImage.empty()) {
+                const int encodedSize = static_cast<int>(nativeResults.encodedImage.size());
+                managedResults->EncodedImageData = gcnew array<unsigned char>(encodedSize);
+                Marshal::Copy(IntPtr(const_cast<unsigned char*>(nativeResults.encodedImage.data())),
+                              managedResults->EncodedImageData, 0, encodedSize);
+            }
 
+            if (success) {
                 // Convert impacts
                 for (const auto& impact : nativeResults.impacts) {
                     Impact^ managedImpact = gcnew Impact(
@@ -101,35 +435,25 @@ namespace SubvisionNET {
                     );
                     managedResults->Impacts->Add(managedImpact);
                 }
-            }
-
-            return managedResults;
-        }
-
-        // Get sheet coordinates from image
-        // imageData: RGBA image data as byte array
-        // width: image width
-        // height: image height
-        static List<Point2f^>^ GetSheetCoordinates(array<unsigned char>^ imageData, int width, int height) {
-            // Convert managed array to native vector
-            std::vector<unsigned char> nativeData(imageData->Length);
-            Marshal::Copy((array<unsigned char>^)imageData, 0, IntPtr(nativeData.data()), imageData->Length);
 
-            // Create OpenCV Mat from the data (RGBA format)
-            cv::Mat mat(height, width, CV_8UC4, nativeData.data());
-            cv::Mat bgrMat;
-            cv::cvtColor(mat, bgrMat, cv::COLOR_RGBA2BGR);
-
-            // Call native function
-            std::vector<cv::Point2f> nativePoints = subvision::getSheetCoordinates(bgrMat);
+                for (const auto& entry : nativeResults.targets) {
+                    const subvision::Ellipse& ellipse = entry.second;
+                    TargetEllipse^ target = gcnew TargetEllipse();
+                    target->Zone = entry.first;
+                    target->X = ellipse.center().x;
+                    target->Y = ellipse.center().y;
+                    target->Width = ellipse.axes().width;
+                    target->Height = ellipse.axes().height;
+                    target->Angle = ellipse.angle();
+                    managedResults->Targets->Add(target);
+                }
 
-            // Convert to managed list
-            List<Point2f^>^ managedPoints = gcnew List<Point2f^>();
-            for (const auto& pt : nativePoints) {
-                managedPoints->Add(gcnew Point2f(pt.x, pt.y));
+                for (const auto& primitive : nativeResults.overlay) {
+                    managedResults->Overlay->Add(ToManagedPrimitive(primitive));
+                }
             }
 
-            return managedPoints;
+            return managedResults;
         }
     };
 }
@@ -1,8 +1,20 @@
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
 #include "include/types.h"
+#include "include/image_buffer.h"
+#include "include/processing_context.h"
+#include "include/result.h"
 #include "include/impact_detection.h"
 #include "include/sheet_detection.h"
+#include "include/thread_pool.h"
+#include "include/trace.h"
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#endif
 
 using namespace emscripten;
 
@@ -30,19 +42,179 @@ struct JSImpact {
 struct JSImpactResults {
     cv::Mat annotatedImage;
     val impacts = val::array();
+    // Côté de la feuille redressée du profil de résolution (2000 en PRECISE) : repère de targets et overlay
+    int sheetSize = 0;
+    // Ellipses cibles et primitives d'annotation en coordonnées feuille (sheetSize x sheetSize)
+    val targets = val::array();
+    val overlay = val::array();
+    // Image annotée encodée (Uint8Array), null si aucun encodage n'est demandé
+    val encodedImage = val::null();
+    // Erreur du traitement (ErrorCode.NONE en cas de succès) et zone cible concernée (-1 sinon)
+    subvision::ErrorCode error = subvision::ErrorCode::NONE;
+    int errorZone = -1;
+    std::string errorMessage;
 };
 
+// Taille en octets d'une image contiguë, 0 si la taille est invalide. Calcul en 64 bits : width * height * 4
+// dépasse size_t en WASM 32 bits pour des dimensions aberrantes
+uint64_t getImageByteCount(int width, int height, subvision::PixelFormat format) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    const uint64_t area = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    switch (format) {
+        case subvision::PixelFormat::RGBA:
+            return area * 4;
+        case subvision::PixelFormat::BGR:
+            return area * 3;
+        default:
+            return area * 3 / 2;
+    }
+}
+
+// Image contiguë décrite sur les pixels d'un tableau typé : INVALID_IMAGE si le tableau est plus petit que
+// l'image, avant toute lecture des pixels
 template<typename T>
-val getSheetCoordinates(int width, int height, const val &typedArray) {
-    std::cout << "Start processing getSheetCoordinates with width: " << width << ", height: " << height << std::endl;
-    std::vector<T> vec = convertJSArrayToNumberVector<T>(typedArray);
-    std::cout << "Vector size: " << vec.size() << std::endl;
-    cv::Mat mat(height, width, CV_8UC4, vec.data());
-    cv::cvtColor(mat, mat, cv::COLOR_RGBA2BGR);
+subvision::Result<subvision::ImageBuffer> describeTypedArray(subvision::PixelFormat format, int width, int height,
+                                                             const std::vector<T> &pixels) {
+    const uint64_t required = getImageByteCount(width, height, format);
+    if (required != 0 && static_cast<uint64_t>(pixels.size()) * sizeof(T) < required) {
+        return subvision::Unexpected(subvision::ProcessingError{
+            subvision::ErrorCode::INVALID_IMAGE, -1, "Image data is smaller than the image size"
+        });
+    }
+    const auto *data = reinterpret_cast<const uchar *>(pixels.data());
+    if (subvision::isYuvFormat(format)) {
+        return subvision::tryMakeContiguousYuvImageBuffer(format, width, height, data);
+    }
+    return subvision::tryMakePackedImageBuffer(format, width, height, data);
+}
+
+// Image allouée sur le tas WASM : JavaScript écrit les pixels directement dans data(),
+// le traitement lit ensuite le buffer sur place sans copie ni conversion de l'image complète
+class JSImageBuffer {
+public:
+    JSImageBuffer(int width, int height, subvision::PixelFormat format)
+        : width(width), height(height), format(format), pixels(getBufferSize(width, height, format)) {
+    }
+
+    int getWidth() const {
+        return width;
+    }
 
-    std::cout << "Processing getSheetCoordinates with width: " << width << ", height: " << height << std::endl;
-    auto points = subvision::getSheetCoordinates(mat);
+    int getHeight() const {
+        return height;
+    }
+
+    subvision::PixelFormat getFormat() const {
+        return format;
+    }
+
+    // Vue sur la mémoire WASM, à redemander après chaque appel qui peut agrandir la mémoire
+    val data() {
+        return val(typed_memory_view(pixels.size(), pixels.data()));
+    }
+
+    // INVALID_IMAGE si la taille ou le format sont invalides : aucune exception ne traverse la frontière JavaScript
+    subvision::Result<subvision::ImageBuffer> describe() const {
+        return describeTypedArray(format, width, height, pixels);
+    }
+
+private:
+    // Taille invalide : buffer vide, l'erreur est retournée par describe()
+    static size_t getBufferSize(int width, int height, subvision::PixelFormat format) {
+        return static_cast<size_t>(getImageByteCount(width, height, format));
+    }
+
+    int width;
+    int height;
+    subvision::PixelFormat format;
+    std::vector<uchar> pixels;
+};
+
+// Options de traitement partagées par tous les appels. Dans la variante pthreads, le pool des zones
+// est créé au premier appel sur les workers préalloués (PTHREAD_POOL_SIZE), le reste du budget va à OpenCV
+const subvision::ProcessingOptions &getProcessingOptions() {
+    static const subvision::ProcessingOptions options = [] {
+        subvision::ProcessingOptions processingOptions;
+#ifdef __EMSCRIPTEN_PTHREADS__
+        static std::unique_ptr<subvision::ThreadPool> pool;
+        const int budget = SUBVISION_WASM_THREADS;
+        const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        // Une tâche par zone cible : au-delà de 5 workers le pool n'est plus utilisé
+        const int poolSize = std::min({5, cores, budget});
+        if (poolSize > 1) {
+            pool = std::make_unique<subvision::ThreadPool>(poolSize);
+            processingOptions.threadPool = pool.get();
+        }
+        cv::setNumThreads(std::max(1, std::min(cores, budget - poolSize)));
+        SUBVISION_LOG_INFO("WASM threads: " << poolSize << " zone workers, " << cv::getNumThreads()
+                           << " OpenCV threads");
+#endif
+        return processingOptions;
+    }();
+    return options;
+}
 
+// Options partagées avec l'annotation, l'encodage et la résolution demandés par l'appel
+subvision::ProcessingOptions getProcessingOptions(subvision::AnnotationMode annotationMode,
+                                                  const subvision::EncodingOptions &encoding,
+                                                  subvision::ResolutionProfile resolution) {
+    subvision::ProcessingOptions options = getProcessingOptions();
+    options.annotationMode = annotationMode;
+    options.encoding = encoding;
+    options.resolution = resolution;
+    return options;
+}
+
+// Nombre de workers utilisés pour traiter les zones en parallèle (1 dans la variante sans pthreads)
+int getThreadCount() {
+    const subvision::ProcessingOptions &options = getProcessingOptions();
+    return options.threadPool ? static_cast<int>(options.threadPool->size()) : 1;
+}
+
+// Traitement avec un contexte partagé par tous les appels (JavaScript n'en lance qu'un à la fois) :
+// les images intermédiaires ne sont allouées qu'une fois sur le tas WASM. Une feuille retournée
+// à JavaScript est détachée du contexte pour ne pas être réécrite par l'appel suivant
+template<typename Image>
+bool retrieveImpactsWithContext(const Image &image, subvision::ImpactResults &results,
+                                const subvision::ProcessingOptions &options) {
+    static subvision::ProcessingContext context;
+    // Les erreurs sont retournées dans les résultats, aucune exception ne traverse la frontière JavaScript
+    const subvision::Status status = subvision::catchErrors([&] {
+        return subvision::tryRetrieveImpacts(image, results, options, context);
+    });
+    if (!status) {
+        SUBVISION_LOG_WARNING("retrieveImpacts failed: " << status.error().message);
+        results.error = status.error();
+        return false;
+    }
+    if (!results.annotatedImage.empty()) {
+        context.detachResults();
+    }
+    return true;
+}
+
+// Coins de la feuille, tableau vide si aucune feuille n'est trouvée
+std::vector<cv::Point2f> findSheetCoordinates(const subvision::ImageBuffer &image) {
+    static subvision::ProcessingContext context;
+    std::vector<cv::Point2f> coordinates;
+    const subvision::Status status = subvision::catchErrors([&]() -> subvision::Status {
+        auto result = subvision::tryGetSheetCoordinates(image, context);
+        if (!result) {
+            return subvision::Unexpected(result.error());
+        }
+        coordinates = std::move(*result);
+        return {};
+    });
+    if (!status) {
+        SUBVISION_LOG_DEBUG("getSheetCoordinates failed: " << status.error().message);
+    }
+    return coordinates;
+}
+
+// Conversion des coins de la feuille pour JavaScript
+val toJSPoints(const std::vector<cv::Point2f> &points) {
     val jsArray = val::array();
     for (const auto &pt: points) {
         val jsPoint = val::object();
@@ -54,39 +226,231 @@ val getSheetCoordinates(int width, int height, const val &typedArray) {
     return jsArray;
 }
 
-
-// Fonction wrapper pour retrieveImpacts
 template<typename T>
-JSImpactResults processTargetImage(int width, int height, const val &typedArray) {
-    subvision::ImpactResults results;
-    auto start = std::chrono::high_resolution_clock::now();
-
+val getSheetCoordinates(int width, int height, const val &typedArray) {
+    SUBVISION_TRACE_SCOPE("js::getSheetCoordinates");
+    SUBVISION_LOG_DEBUG("getSheetCoordinates with width: " << width << ", height: " << height);
     std::vector<T> vec = convertJSArrayToNumberVector<T>(typedArray);
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
-    std::cout << "Temps écoulé pour vecFromJSArray: " << elapsed.count() << " secondes" << std::endl;
-    cv::Mat mat(height, width, CV_8UC4, vec.data());
-    cv::cvtColor(mat, mat, cv::COLOR_RGBA2BGR);
+    // La détection de la feuille lit directement les pixels RGBA
+    const subvision::Result<subvision::ImageBuffer> image =
+        describeTypedArray(subvision::PixelFormat::RGBA, width, height, vec);
+    if (!image) {
+        SUBVISION_LOG_DEBUG("getSheetCoordinates failed: " << image.error().message);
+        return toJSPoints({});
+    }
 
-    bool success = subvision::retrieveImpacts(mat, results);
+    return toJSPoints(findSheetCoordinates(*image));
+}
+
+val getImageBufferSheetCoordinates(const JSImageBuffer &buffer) {
+    SUBVISION_TRACE_SCOPE("js::getImageBufferSheetCoordinates");
+    const subvision::Result<subvision::ImageBuffer> image = buffer.describe();
+    if (!image) {
+        SUBVISION_LOG_DEBUG("getImageBufferSheetCoordinates failed: " << image.error().message);
+        return toJSPoints({});
+    }
+    return toJSPoints(findSheetCoordinates(*image));
+}
+
+// Couleur BGR native en tableau [r, g, b] pour le canvas
+val toJSColor(const cv::Scalar &color) {
+    val jsColor = val::array();
+    jsColor.call<void>("push", color[2]);
+    jsColor.call<void>("push", color[1]);
+    jsColor.call<void>("push", color[0]);
+    return jsColor;
+}
+
+// Primitive d'annotation pour JavaScript, seuls les champs utiles au type sont renseignés
+val toJSPrimitive(const subvision::OverlayPrimitive &primitive) {
+    val jsPrimitive = val::object();
+    jsPrimitive.set("x", primitive.position.x);
+    jsPrimitive.set("y", primitive.position.y);
+    jsPrimitive.set("color", toJSColor(primitive.color));
+    jsPrimitive.set("thickness", primitive.thickness);
+    switch (primitive.type) {
+        case subvision::OverlayPrimitiveType::ELLIPSE:
+            jsPrimitive.set("type", std::string("ellipse"));
+            jsPrimitive.set("radiusX", primitive.axes.width);
+            jsPrimitive.set("radiusY", primitive.axes.height);
+            jsPrimitive.set("angle", primitive.angle);
+            break;
+        case subvision::OverlayPrimitiveType::LINE:
+            jsPrimitive.set("type", std::string("line"));
+            jsPrimitive.set("x2", primitive.end.x);
+            jsPrimitive.set("y2", primitive.end.y);
+            break;
+        case subvision::OverlayPrimitiveType::POINT:
+            jsPrimitive.set("type", std::string("point"));
+            jsPrimitive.set("radius", primitive.size);
+            break;
+        case subvision::OverlayPrimitiveType::LABEL:
+            jsPrimitive.set("type", std::string("label"));
+            jsPrimitive.set("fontScale", primitive.size);
+            jsPrimitive.set("text", primitive.text);
+            break;
+    }
+    return jsPrimitive;
+}
 
+// Conversion des résultats natifs pour JavaScript
+JSImpactResults toJSResults(const subvision::ImpactResults &results, const bool success) {
     JSImpactResults jsResults;
+    jsResults.error = results.error.code;
+    jsResults.errorZone = results.error.zone;
+    jsResults.errorMessage = results.error.message;
     if (success) {
-        auto annotated_image = results.annotatedImage;
-        cv::cvtColor(annotated_image, annotated_image, cv::COLOR_BGR2RGBA);
-        jsResults.annotatedImage = annotated_image;
+        // Pas d'image en mode AnnotationMode.NONE : ni conversion ni copie
+        if (!results.annotatedImage.empty()) {
+            cv::cvtColor(results.annotatedImage, jsResults.annotatedImage, cv::COLOR_BGR2RGBA);
+        }
 
         val impactArray = val::array();
         for (const auto& impact : results.impacts) {
             impactArray.call<void>("push", JSImpact::fromImpact(impact));
         }
         jsResults.impacts = impactArray;
+
+        for (const auto &[zone, ellipse]: results.targets) {
+            val jsTarget = val::object();
+            jsTarget.set("zone", zone);
+            jsTarget.set("x", ellipse.center().x);
+            jsTarget.set("y", ellipse.center().y);
+            jsTarget.set("width", ellipse.axes().width);
+            jsTarget.set("height", ellipse.axes().height);
+            jsTarget.set("angle", ellipse.angle());
+            jsResults.targets.call<void>("push", jsTarget);
+        }
+
+        for (const auto &primitive: results.overlay) {
+            jsResults.overlay.call<void>("push", toJSPrimitive(primitive));
+        }
+
+        if (!results.encodedImage.empty()) {
+            // Copie dans un Uint8Array JavaScript, indépendant du tas WASM
+            jsResults.encodedImage = val::global("Uint8Array").new_(
+                typed_memory_view(results.encodedImage.size(), results.encodedImage.data()));
+        }
     }
 
+    return jsResults;
+}
 
+// Traitement d'une image décrite par les arguments JavaScript : une taille ou un format invalide
+// est retourné en INVALID_IMAGE dans les résultats, sans traitement
+JSImpactResults processDescribedImage(const subvision::Result<subvision::ImageBuffer> &image,
+                                      const subvision::ProcessingOptions &options) {
+    subvision::ImpactResults results;
+    JSImpactResults jsResults;
+    if (!image) {
+        SUBVISION_LOG_WARNING("Invalid image: " << image.error().message);
+        results.error = image.error();
+        jsResults = toJSResults(results, false);
+    } else {
+        const bool success = retrieveImpactsWithContext(*image, results, options);
+        jsResults = toJSResults(results, success);
+    }
+    jsResults.sheetSize = subvision::getProcessingProfile(options.resolution).sheetSize;
     return jsResults;
 }
 
+// Fonction wrapper pour retrieveImpacts
+template<typename T>
+JSImpactResults processTargetImage(int width, int height, const val &typedArray,
+                                   subvision::AnnotationMode annotationMode,
+                                   const subvision::EncodingOptions &encoding,
+                                   subvision::ResolutionProfile resolution) {
+    SUBVISION_TRACE_SCOPE("js::processTargetImage");
+    std::vector<T> vec;
+    {
+        SUBVISION_TRACE_SCOPE("js::convertJSArrayToNumberVector");
+        vec = convertJSArrayToNumberVector<T>(typedArray);
+    }
+    // Pas de conversion RGBA -> BGR de l'image complète : seule la feuille redressée est convertie
+    const subvision::Result<subvision::ImageBuffer> image =
+        describeTypedArray(subvision::PixelFormat::RGBA, width, height, vec);
+    return processDescribedImage(image, getProcessingOptions(annotationMode, encoding, resolution));
+}
+
+// Traitement d'une image YUV 4:2:0 de la caméra (NV12, NV21 ou I420 dans un buffer contigu)
+template<typename T>
+JSImpactResults processYuvImage(int width, int height, subvision::PixelFormat format, const val &typedArray,
+                                subvision::AnnotationMode annotationMode,
+                                const subvision::EncodingOptions &encoding,
+                                subvision::ResolutionProfile resolution) {
+    SUBVISION_TRACE_SCOPE("js::processYuvImage");
+    std::vector<T> vec;
+    {
+        SUBVISION_TRACE_SCOPE("js::convertJSArrayToNumberVector");
+        vec = convertJSArrayToNumberVector<T>(typedArray);
+    }
+    const subvision::Result<subvision::ImageBuffer> image = describeTypedArray(format, width, height, vec);
+    return processDescribedImage(image, getProcessingOptions(annotationMode, encoding, resolution));
+}
+
+// Traitement sur place d'une image déjà écrite dans le tas WASM
+JSImpactResults processImageBuffer(const JSImageBuffer &buffer, subvision::AnnotationMode annotationMode,
+                                   const subvision::EncodingOptions &encoding,
+                                   subvision::ResolutionProfile resolution) {
+    SUBVISION_TRACE_SCOPE("js::processImageBuffer");
+    return processDescribedImage(buffer.describe(), getProcessingOptions(annotationMode, encoding, resolution));
+}
+
+// Variantes sans résolution (PRECISE), sans encodage, puis sans mode d'annotation : feuille annotée
+// (AnnotationMode.RASTER)
+template<typename T>
+JSImpactResults processTargetImageWithEncoding(int width, int height, const val &typedArray,
+                                               subvision::AnnotationMode annotationMode,
+                                               const subvision::EncodingOptions &encoding) {
+    return processTargetImage<T>(width, height, typedArray, annotationMode, encoding,
+                                 subvision::ResolutionProfile::PRECISE);
+}
+
+template<typename T>
+JSImpactResults processTargetImageWithMode(int width, int height, const val &typedArray,
+                                           subvision::AnnotationMode annotationMode) {
+    return processTargetImageWithEncoding<T>(width, height, typedArray, annotationMode,
+                                             subvision::EncodingOptions());
+}
+
+template<typename T>
+JSImpactResults processTargetImageRaster(int width, int height, const val &typedArray) {
+    return processTargetImageWithMode<T>(width, height, typedArray, subvision::AnnotationMode::RASTER);
+}
+
+template<typename T>
+JSImpactResults processYuvImageWithEncoding(int width, int height, subvision::PixelFormat format,
+                                            const val &typedArray, subvision::AnnotationMode annotationMode,
+                                            const subvision::EncodingOptions &encoding) {
+    return processYuvImage<T>(width, height, format, typedArray, annotationMode, encoding,
+                              subvision::ResolutionProfile::PRECISE);
+}
+
+template<typename T>
+JSImpactResults processYuvImageWithMode(int width, int height, subvision::PixelFormat format, const val &typedArray,
+                                        subvision::AnnotationMode annotationMode) {
+    return processYuvImageWithEncoding<T>(width, height, format, typedArray, annotationMode,
+                                          subvision::EncodingOptions());
+}
+
+template<typename T>
+JSImpactResults processYuvImageRaster(int width, int height, subvision::PixelFormat format, const val &typedArray) {
+    return processYuvImageWithMode<T>(width, height, format, typedArray, subvision::AnnotationMode::RASTER);
+}
+
+JSImpactResults processImageBufferWithEncoding(const JSImageBuffer &buffer, subvision::AnnotationMode annotationMode,
+                                               const subvision::EncodingOptions &encoding) {
+    return processImageBuffer(buffer, annotationMode, encoding, subvision::ResolutionProfile::PRECISE);
+}
+
+JSImpactResults processImageBufferWithMode(const JSImageBuffer &buffer, subvision::AnnotationMode annotationMode) {
+    return processImageBufferWithEncoding(buffer, annotationMode, subvision::EncodingOptions());
+}
+
+JSImpactResults processImageBufferRaster(const JSImageBuffer &buffer) {
+    return processImageBufferWithMode(buffer, subvision::AnnotationMode::RASTER);
+}
+
 template<typename T>
 val matData(const cv::Mat &mat) {
     return val(memory_view<T>((mat.total() * mat.elemSize()) / sizeof(T),
@@ -116,10 +480,76 @@ EMSCRIPTEN_BINDINGS (subvision_module) {
 
     register_vector<JSImpact>("ImpactVector");
 
+    enum_<subvision::PixelFormat>("PixelFormat")
+            .value("RGBA", subvision::PixelFormat::RGBA)
+            .value("NV12", subvision::PixelFormat::NV12)
+            .value("NV21", subvision::PixelFormat::NV21)
+            .value("I420", subvision::PixelFormat::I420);
+
+    enum_<subvision::AnnotationMode>("AnnotationMode")
+            .value("RASTER", subvision::AnnotationMode::RASTER)
+            .value("VECTOR", subvision::AnnotationMode::VECTOR)
+            .value("NONE", subvision::AnnotationMode::NONE);
+
+    enum_<subvision::ResolutionProfile>("ResolutionProfile")
+            .value("FAST", subvision::ResolutionProfile::FAST)
+            .value("BALANCED", subvision::ResolutionProfile::BALANCED)
+            .value("PRECISE", subvision::ResolutionProfile::PRECISE);
+
+    enum_<subvision::ErrorCode>("ErrorCode")
+            .value("NONE", subvision::ErrorCode::NONE)
+            .value("INVALID_IMAGE", subvision::ErrorCode::INVALID_IMAGE)
+            .value("NO_SHEET", subvision::ErrorCode::NO_SHEET)
+            .value("DEGENERATE_HOMOGRAPHY", subvision::ErrorCode::DEGENERATE_HOMOGRAPHY)
+            .value("INVALID_TARGET_ELLIPSE", subvision::ErrorCode::INVALID_TARGET_ELLIPSE)
+            .value("ENCODING_FAILED", subvision::ErrorCode::ENCODING_FAILED)
+            .value("INTERNAL", subvision::ErrorCode::INTERNAL);
+
     value_object<JSImpactResults>("ImpactResults")
             .field("annotatedImage", &JSImpactResults::annotatedImage)
-            .field("impacts", &JSImpactResults::impacts);
+            .field("sheetSize", &JSImpactResults::sheetSize)
+            .field("impacts", &JSImpactResults::impacts)
+            .field("targets", &JSImpactResults::targets)
+            .field("overlay", &JSImpactResults::overlay)
+            .field("encodedImage", &JSImpactResults::encodedImage)
+            .field("error", &JSImpactResults::error)
+            .field("errorZone", &JSImpactResults::errorZone)
+            .field("errorMessage", &JSImpactResults::errorMessage);
+
+    enum_<subvision::ImageEncoding>("ImageEncoding")
+            .value("NONE", subvision::ImageEncoding::NONE)
+            .value("JPEG", subvision::ImageEncoding::JPEG)
+            .value("WEBP", subvision::ImageEncoding::WEBP)
+            .value("PNG", subvision::ImageEncoding::PNG);
 
+    value_object<subvision::EncodingOptions>("EncodingOptions")
+            .field("format", &subvision::EncodingOptions::format)
+            .field("maxDimension", &subvision::EncodingOptions::maxDimension)
+            .field("quality", &subvision::EncodingOptions::quality)
+            .field("keepImage", &subvision::EncodingOptions::keepImage);
+
+    // Surcharges par nombre d'arguments : le mode d'annotation et l'encodage sont optionnels
+    function("processTargetImage", &processTargetImageRaster<unsigned char>);
+    function("processTargetImage", &processTargetImageWithMode<unsigned char>);
+    function("processTargetImage", &processTargetImageWithEncoding<unsigned char>);
     function("processTargetImage", &processTargetImage<unsigned char>);
+    function("processYuvImage", &processYuvImageRaster<unsigned char>);
+    function("processYuvImage", &processYuvImageWithMode<unsigned char>);
+    function("processYuvImage", &processYuvImageWithEncoding<unsigned char>);
+    function("processYuvImage", &processYuvImage<unsigned char>);
+
+    class_<JSImageBuffer>("ImageBuffer")
+            .constructor<int, int, subvision::PixelFormat>()
+            .property("width", &JSImageBuffer::getWidth)
+            .property("height", &JSImageBuffer::getHeight)
+            .property("format", &JSImageBuffer::getFormat)
+            .function("data", &JSImageBuffer::data);
+
+    function("processImageBuffer", &processImageBufferRaster);
+    function("processImageBuffer", &processImageBufferWithMode);
+    function("processImageBuffer", &processImageBufferWithEncoding);
+    function("processImageBuffer", &processImageBuffer);
+    function("getImageBufferSheetCoordinates", &getImageBufferSheetCoordinates);
     function("getSheetCoordinates", &getSheetCoordinates<unsigned char>);
+    function("getThreadCount", &getThreadCount);
 }
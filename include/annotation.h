@@ -0,0 +1,36 @@
+#ifndef SUBVISION_CORE_ANNOTATION_H
+#define SUBVISION_CORE_ANNOTATION_H
+
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "result.h"
+#include "types.h"
+
+namespace subvision {
+    // Ellipse du tuple (axes complets), la primitive conserve les demi-axes
+    OverlayPrimitive makeEllipsePrimitive(const Ellipse &ellipse, const cv::Scalar &color, int thickness);
+
+    OverlayPrimitive makeLinePrimitive(const cv::Point2f &from, const cv::Point2f &to, const cv::Scalar &color,
+                                       int thickness);
+
+    // Disque plein
+    OverlayPrimitive makePointPrimitive(const cv::Point2f &center, float radius, const cv::Scalar &color);
+
+    OverlayPrimitive makeLabelPrimitive(const std::string &text, const cv::Point2f &origin, float fontScale,
+                                        const cv::Scalar &color, int thickness);
+
+    // Ajouter les primitives des cibles (contrat, mouche, blancs et croix) en coordonnées feuille
+    void appendTargetsOverlay(const std::map<int, Ellipse> &targetsEllipsis, std::vector<OverlayPrimitive> &overlay);
+
+    // Dessiner les primitives sur la feuille, dans l'ordre de la liste
+    void drawOverlay(const std::vector<OverlayPrimitive> &overlay, cv::Mat &sheetMat);
+
+    // Réduire puis encoder l'image (JPEG, WEBP ou PNG), nécessite le module imgcodecs d'OpenCV
+    std::vector<uchar> encodeImage(const cv::Mat &image, const EncodingOptions &options);
+
+    // Variante sans exception : ENCODING_FAILED en cas d'échec, encoded vide si aucun encodage n'est demandé
+    Status tryEncodeImage(const cv::Mat &image, const EncodingOptions &options, std::vector<uchar> &encoded);
+}
+
+#endif //SUBVISION_CORE_ANNOTATION_H
@@ -0,0 +1,51 @@
+#ifndef SUBVISION_CORE_BATCH_PROCESSING_H
+#define SUBVISION_CORE_BATCH_PROCESSING_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "types.h"
+
+namespace subvision {
+    struct BatchOptions {
+        // Nombre total de workers répartis entre les étapes, 0 utilise le nombre de coeurs
+        std::size_t workerCount = 0;
+        // Nombre maximal d'images en attente entre deux étapes (contre-pression)
+        std::size_t queueCapacity = 4;
+        // Partager les coeurs avec les threads internes d'OpenCV (cv::parallel_for_) en réduisant cv::setNumThreads
+        // pendant le batch. Le réglage est global : à désactiver si plusieurs batchs ou traitements tournent en même
+        // temps, le nombre de workers par défaut est alors déduit de cv::getNumThreads()
+        bool limitOpenCVThreads = true;
+        // Options appliquées à chaque image, le pool de threads est ignoré en mode batch
+        ProcessingOptions processing;
+    };
+
+    // Résultat d'une image du batch, une erreur n'interrompt pas le reste du batch
+    struct BatchItemResult {
+        std::size_t index = 0;
+        std::string source;
+        bool success = false;
+        ImpactResults results;
+        std::string error;
+    };
+
+    // Répartition des coeurs entre les workers du batch et les threads internes d'OpenCV
+    struct BatchThreads {
+        std::size_t workerCount = 1;
+        int openCVThreads = 1;
+    };
+
+    // Threads d'un batch : workerCount * openCVThreads ne dépasse pas le nombre de coeurs, sauf si
+    // BatchOptions::workerCount est imposé au-delà
+    BatchThreads getBatchThreads(const BatchOptions &options = BatchOptions());
+
+    // Traiter un ensemble d'images, les résultats sont dans l'ordre des entrées
+    std::vector<BatchItemResult> retrieveImpactsBatch(const std::vector<cv::Mat> &images,
+                                                      const BatchOptions &options = BatchOptions());
+
+    // Traiter un ensemble de fichiers image, le décodage fait partie du pipeline
+    std::vector<BatchItemResult> retrieveImpactsBatch(const std::vector<std::string> &paths,
+                                                      const BatchOptions &options = BatchOptions());
+}
+
+#endif //SUBVISION_CORE_BATCH_PROCESSING_H
@@ -0,0 +1,24 @@
+#ifndef SUBVISION_CORE_COLOR_KERNELS_H
+#define SUBVISION_CORE_COLOR_KERNELS_H
+
+#include <opencv2/core.hpp>
+
+namespace subvision {
+    // Noyaux de conversion qui calculent un seul canal directement depuis une image BGR 8 bits,
+    // sans image intermédiaire à 3 canaux ni split. Les valeurs sont identiques à celles de cvtColor.
+    // Le minimum et le maximum du canal sont calculés dans la même passe lorsque minVal/maxVal sont fournis.
+
+    // Canal S de COLOR_BGR2HSV
+    void extractSaturation(const cv::Mat &bgr, cv::Mat &saturation, double *minVal = nullptr,
+                           double *maxVal = nullptr);
+
+    // Canal L de COLOR_BGR2HLS, l'image peut aussi être à 4 canaux (BGRA ou RGBA)
+    void extractLightness(const cv::Mat &bgr, cv::Mat &lightness, double *minVal = nullptr,
+                          double *maxVal = nullptr);
+
+    // Canal Z de COLOR_BGR2XYZ inversé (255 - Z)
+    void extractInvertedZ(const cv::Mat &bgr, cv::Mat &invertedZ, double *minVal = nullptr,
+                          double *maxVal = nullptr);
+}
+
+#endif //SUBVISION_CORE_COLOR_KERNELS_H
@@ -1,7 +1,9 @@
 #ifndef SUBVISION_CORE_CONSTANTS_H
 #define SUBVISION_CORE_CONSTANTS_H
 
+#include <array>
 #include <opencv2/opencv.hpp>
+#include "resolution_profile.h"
 
 namespace subvision {
     const int SUBVISION_ZONE_TOP_LEFT = 0;
@@ -11,10 +13,26 @@ namespace subvision {
     const int SUBVISION_ZONE_CENTER = 4;
     const int SUBVISION_ZONE_UNDEFINED = -1;
 
-    const int PICTURE_WIDTH_SHEET_DETECTION = 2000;
-    const int PICTURE_HEIGHT_SHEET_DETECTION = 2000;
-    const cv::Size KERNEL_SIZE(PICTURE_WIDTH_SHEET_DETECTION / 200, PICTURE_WIDTH_SHEET_DETECTION / 200);
-    const cv::Mat ROUND_KERNEL = cv::getStructuringElement(cv::MORPH_ELLIPSE, KERNEL_SIZE);
+    // Zones des cibles dans l'ordre de traitement
+    const std::array<int, 5> TARGET_ZONES = {
+        SUBVISION_ZONE_TOP_LEFT, SUBVISION_ZONE_TOP_RIGHT, SUBVISION_ZONE_CENTER,
+        SUBVISION_ZONE_BOTTOM_LEFT, SUBVISION_ZONE_BOTTOM_RIGHT
+    };
+
+    // Feuille redressée du profil PRECISE (voir ResolutionProfile)
+    const int PICTURE_WIDTH_SHEET_DETECTION = REFERENCE_SHEET_SIZE;
+    const int PICTURE_HEIGHT_SHEET_DETECTION = REFERENCE_SHEET_SIZE;
+
+    // Position attendue du centre de chaque cible sur la feuille de référence, indexée par zone
+    const std::array<cv::Point2f, 5> TARGET_EXPECTED_CENTERS = {
+        cv::Point2f(480, 500), cv::Point2f(1500, 500), cv::Point2f(475, 1525), cv::Point2f(1495, 1525),
+        cv::Point2f(990, 1010)
+    };
+    // Anneaux des cibles relativement au visuel détecté : mouche, petit, moyen et grand blanc
+    const std::array<float, 4> TARGET_RING_FACTORS = {0.2f, 0.6f, 1.4f, 1.8f};
+
+    // Plus grande dimension de l'image réduite de la détection rapide de la feuille
+    const int PROXY_SHEET_DETECTION_SIZE = 512;
 }
 
 #endif //SUBVISION_CORE_CONSTANTS_H
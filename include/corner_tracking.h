@@ -0,0 +1,32 @@
+#ifndef SUBVISION_CORE_CORNER_TRACKING_H
+#define SUBVISION_CORE_CORNER_TRACKING_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace subvision {
+    // Motifs de référence en niveaux de gris autour des coins de la feuille, capturés sur une image
+    // pour retrouver les coins dans les images suivantes
+    struct CornerPatches {
+        // Motif vide pour un coin trop proche du bord de l'image
+        std::vector<cv::Mat> patches;
+        // Écart entre chaque coin et le centre entier de son motif
+        std::vector<cv::Point2f> offsets;
+        // Demi-taille des motifs, en pixels de l'image source
+        int radius = 0;
+
+        void clear();
+    };
+
+    // Capturer les motifs de côté 2 * patchRadius + 1 autour des coins d'une image BGR
+    void storeCornerPatches(const cv::Mat &frame, const std::vector<cv::Point2f> &corners, int patchRadius,
+                            CornerPatches &patches);
+
+    // Retrouver chaque coin par corrélation (TM_CCOEFF_NORMED) à ±searchRadius pixels de sa position,
+    // au sous-pixel près. Retourne la corrélation du coin le moins bien retrouvé, ou -1 si un coin
+    // ne peut pas être cherché (motif absent, fenêtre hors de l'image)
+    float matchCornerPatches(const cv::Mat &frame, const std::vector<cv::Point2f> &corners,
+                             const CornerPatches &patches, int searchRadius, std::vector<cv::Point2f> &matched);
+}
+
+#endif //SUBVISION_CORE_CORNER_TRACKING_H
@@ -0,0 +1,117 @@
+#ifndef SUBVISION_CORE_ELLIPSE_H
+#define SUBVISION_CORE_ELLIPSE_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <opencv2/core.hpp>
+
+namespace subvision {
+    // Ellipse au format cv::RotatedRect (axes complets, orientation en degrés). Les demi-axes, leurs inverses et
+    // le sinus / cosinus de l'orientation sont calculés une fois à la construction : les requêtes n'ont plus de
+    // trigonométrie sur l'orientation
+    class Ellipse {
+    public:
+        Ellipse() = default;
+
+        Ellipse(const cv::Point2f &center, const cv::Size2f &axes, const float angle)
+            : centerPoint(center), axesSize(axes), angleDegrees(angle),
+              halfWidthValue(axes.width * 0.5f), halfHeightValue(axes.height * 0.5f),
+              inverseHalfWidth(axes.width > 0 ? 2.0f / axes.width : 0.0f),
+              inverseHalfHeight(axes.height > 0 ? 2.0f / axes.height : 0.0f),
+              cosAngle(std::cos(angle * static_cast<float>(CV_PI) / 180.0f)),
+              sinAngle(std::sin(angle * static_cast<float>(CV_PI) / 180.0f)) {
+        }
+
+        explicit Ellipse(const cv::RotatedRect &rect) : Ellipse(rect.center, rect.size, rect.angle) {
+        }
+
+        const cv::Point2f &center() const { return centerPoint; }
+
+        // Axes complets
+        const cv::Size2f &axes() const { return axesSize; }
+
+        // Orientation en degrés
+        float angle() const { return angleDegrees; }
+
+        float halfWidth() const { return halfWidthValue; }
+
+        float halfHeight() const { return halfHeightValue; }
+
+        bool empty() const { return axesSize.width <= 0 || axesSize.height <= 0; }
+
+        cv::RotatedRect toRotatedRect() const { return {centerPoint, axesSize, angleDegrees}; }
+
+        // Point de paramètre t (radians) dans le repère de l'ellipse, orientation comprise
+        cv::Point2f pointAt(const float t) const {
+            return pointAt(std::cos(t), std::sin(t));
+        }
+
+        // Idem avec le cosinus et le sinus du paramètre déjà calculés
+        cv::Point2f pointAt(const float cosT, const float sinT) const {
+            const float u = cosT * halfWidthValue;
+            const float v = sinT * halfHeightValue;
+            return {centerPoint.x + u * cosAngle - v * sinAngle, centerPoint.y + u * sinAngle + v * cosAngle};
+        }
+
+        // Distance normalisée au centre : 0 au centre, 1 sur l'ellipse, proportionnelle le long d'un rayon
+        float radialDistance(const cv::Point2f &point) const {
+            const float dx = point.x - centerPoint.x;
+            const float dy = point.y - centerPoint.y;
+            const float u = (dx * cosAngle + dy * sinAngle) * inverseHalfWidth;
+            const float v = (dy * cosAngle - dx * sinAngle) * inverseHalfHeight;
+            return std::sqrt(u * u + v * v);
+        }
+
+        // Indice du premier anneau (facteurs d'agrandissement croissants) contenant le point,
+        // count si le point est hors de tous les anneaux
+        std::size_t ring(const cv::Point2f &point, const float *factors, const std::size_t count) const {
+            const float distance = radialDistance(point);
+            std::size_t index = 0;
+            while (index < count && distance > factors[index]) {
+                ++index;
+            }
+            return index;
+        }
+
+        template<std::size_t N>
+        std::size_t ring(const cv::Point2f &point, const std::array<float, N> &factors) const {
+            return ring(point, factors.data(), N);
+        }
+
+        // Ellipse agrandie d'un facteur, même centre et même orientation (sinus / cosinus repris tels quels)
+        Ellipse grown(const float factor) const {
+            Ellipse result = *this;
+            result.axesSize = cv::Size2f(axesSize.width * factor, axesSize.height * factor);
+            result.halfWidthValue = halfWidthValue * factor;
+            result.halfHeightValue = halfHeightValue * factor;
+            result.inverseHalfWidth = factor != 0 ? inverseHalfWidth / factor : 0.0f;
+            result.inverseHalfHeight = factor != 0 ? inverseHalfHeight / factor : 0.0f;
+            return result;
+        }
+
+        Ellipse translated(const cv::Point2f &offset) const {
+            Ellipse result = *this;
+            result.centerPoint += offset;
+            return result;
+        }
+
+        bool operator==(const Ellipse &other) const {
+            return centerPoint == other.centerPoint && axesSize == other.axesSize &&
+                   angleDegrees == other.angleDegrees;
+        }
+
+    private:
+        cv::Point2f centerPoint;
+        cv::Size2f axesSize;
+        float angleDegrees = 0;
+        float halfWidthValue = 0;
+        float halfHeightValue = 0;
+        float inverseHalfWidth = 0;
+        float inverseHalfHeight = 0;
+        float cosAngle = 1;
+        float sinAngle = 0;
+    };
+}
+
+#endif //SUBVISION_CORE_ELLIPSE_H
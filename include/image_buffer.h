@@ -0,0 +1,45 @@
+#ifndef SUBVISION_CORE_IMAGE_BUFFER_H
+#define SUBVISION_CORE_IMAGE_BUFFER_H
+
+#include <opencv2/opencv.hpp>
+#include "result.h"
+#include "types.h"
+
+namespace subvision {
+    // Décrire une image packée BGR ou RGBA, un pas nul correspond à des lignes contiguës
+    ImageBuffer makePackedImageBuffer(PixelFormat format, int width, int height, const uchar *data,
+                                      size_t stride = 0);
+
+    // Décrire une image NV12 ou NV21 (plan Y et plan de chrominance entrelacée)
+    ImageBuffer makeSemiPlanarImageBuffer(PixelFormat format, int width, int height, const uchar *y, size_t yStride,
+                                          const uchar *uv, size_t uvStride);
+
+    // Décrire une image I420 (plans Y, U et V)
+    ImageBuffer makePlanarImageBuffer(int width, int height, const uchar *y, size_t yStride, const uchar *u,
+                                      size_t uStride, const uchar *v, size_t vStride);
+
+    // Décrire une image YUV 4:2:0 (NV12, NV21 ou I420) stockée dans un seul buffer contigu
+    ImageBuffer makeContiguousYuvImageBuffer(PixelFormat format, int width, int height, const uchar *data);
+
+    // Variantes sans exception des constructeurs précédents : INVALID_IMAGE si le format, la taille ou les plans
+    // sont invalides (appels depuis JavaScript, où une exception arrêterait le module)
+    Result<ImageBuffer> tryMakePackedImageBuffer(PixelFormat format, int width, int height, const uchar *data,
+                                                 size_t stride = 0);
+
+    Result<ImageBuffer> tryMakeContiguousYuvImageBuffer(PixelFormat format, int width, int height,
+                                                        const uchar *data);
+
+    // Vérifier la taille et les plans de l'image : INVALID_IMAGE avec le détail en cas d'erreur
+    Status validateImageBuffer(const ImageBuffer &image);
+
+    // Le format est-il un format YUV 4:2:0
+    bool isYuvFormat(PixelFormat format);
+
+    // Vue (sans copie) d'un plan de l'image
+    cv::Mat getPlaneView(const ImageBuffer &image, int plane);
+
+    // Convertir l'image complète en BGR
+    cv::Mat toBgr(const ImageBuffer &image);
+}
+
+#endif //SUBVISION_CORE_IMAGE_BUFFER_H
@@ -3,23 +3,63 @@
 
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include "processing_context.h"
 #include "types.h"
 
 namespace subvision {
     // Obtenir le plus grand contour valide
     std::vector<cv::Point> getBiggestValidContour(const std::vector<std::vector<cv::Point>> &contours);
 
+    // Idem pour une image de détection de taille quelconque (les seuils d'aire en dépendent)
+    std::vector<cv::Point> getBiggestValidContour(const std::vector<std::vector<cv::Point>> &contours,
+                                                  const cv::Size &imageSize);
+
     // Obtenir le masque des impacts
     cv::Mat getImpactsMask(const cv::Mat &image);
 
+    // Obtenir le masque des impacts dans les buffers du contexte (le masque retourné est context.impactsMask,
+    // les impacts extraits context.impacts)
+    cv::Mat getImpactsMask(const cv::Mat &image, ProcessingContext &context);
+
+    // Idem avec la morphologie du profil de résolution (PRECISE pour les variantes précédentes)
+    cv::Mat getImpactsMask(const cv::Mat &image, ProcessingContext &context, const ProcessingProfile &profile);
+
+    // Extraire les impacts d'un masque binaire en une passe (composantes connexes et moments d'ordre 2).
+    // Les composantes rectangulaires pleines sont ignorées. Si ellipseMask est fourni, il reçoit les
+    // ellipses des impacts remplies
+    void extractImpacts(const cv::Mat &mask, std::vector<ImpactBlob> &impacts, ProcessingContext &context,
+                        cv::Mat *ellipseMask = nullptr);
+
+    std::vector<ImpactBlob> extractImpacts(const cv::Mat &mask, cv::Mat *ellipseMask = nullptr);
+
+    // Centres des impacts
+    void getImpactsCenters(const std::vector<ImpactBlob> &impacts, std::vector<cv::Point2f> &centers);
+
     // Obtenir les coordonnées des impacts
     std::vector<cv::Point2f> getImpactsCoordinates(const cv::Mat &image);
 
+    // Obtenir les coordonnées des impacts à partir d'un masque déjà calculé
+    std::vector<cv::Point2f> getImpactsCoordinatesFromMask(const cv::Mat &mask);
+
+    // Idem dans les buffers du contexte, valable jusqu'au prochain appel avec ce contexte
+    const std::vector<cv::Point2f> &getImpactsCoordinatesFromMask(const cv::Mat &mask, ProcessingContext &context);
+
+    // Analyser une feuille redressée (masque des impacts calculé une seule fois), avec le profil de résolution
+    // correspondant à son côté
+    SheetAnalysis analyzeSheet(const cv::Mat &sheetMat);
+
+    // Idem dans les buffers du contexte : les impacts extraits sont déplacés de context.impacts vers l'analyse
+    // (sans copie), l'appelant peut les y rendre avec swap pour réutiliser leur capacité
+    SheetAnalysis analyzeSheet(const cv::Mat &sheetMat, ProcessingContext &context);
+
     // Obtenir un masque de couleur
     cv::Mat getColorMask(const cv::Mat &mat, const cv::Scalar &color);
 
     // Extraire une ellipse d'une image
     Ellipse retrieveEllipse(const cv::Mat &image);
+
+    // Idem avec un vecteur de contours réutilisé
+    Ellipse retrieveEllipse(const cv::Mat &image, std::vector<std::vector<cv::Point> > &contours);
 }
 
 #endif //SUBVISION_CORE_IMAGE_PROCESSING_H
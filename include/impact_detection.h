@@ -3,15 +3,77 @@
 
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include "processing_context.h"
+#include "result.h"
+#include "scoring.h"
 #include "types.h"
 
 namespace subvision {
+    // Calculer le score de chaque impact (cible la plus proche), sans dessin.
+    // Les primitives d'annotation des impacts sont ajoutées à overlay s'il est fourni, leurs tailles
+    // multipliées par scale (côté de la feuille / 2000)
+    std::vector<Impact> scoreImpacts(const std::vector<cv::Point2f> &impacts,
+                                     const std::map<int, Ellipse> &targetsEllipsis,
+                                     std::vector<OverlayPrimitive> *overlay = nullptr, float scale = 1.0f);
+
+    // Idem dans points, vidé puis rempli en gardant sa capacité
+    void scoreImpacts(const std::vector<cv::Point2f> &impacts, const std::map<int, Ellipse> &targetsEllipsis,
+                      std::vector<Impact> &points, std::vector<OverlayPrimitive> *overlay = nullptr,
+                      float scale = 1.0f);
+
+    // Ellipses cibles (coordonnées feuille) au format du moteur de score par lots, zones dans l'ordre croissant
+    TargetBatch getTargetBatch(const std::map<int, Ellipse> &targetsEllipsis);
+
     // Dessiner les impacts sur l'image et obtenir les points d'impact
     std::vector<Impact> drawAndGetImpactsPoints(const std::vector<cv::Point2f> &impacts, cv::Mat &sheetMat,
                                                 const std::map<int, Ellipse> &targetsEllipsis);
 
+    // Remplir les résultats (scores, cibles, annotation, image encodée) à partir des impacts et des cibles
+    // en coordonnées feuille, selon le mode d'annotation et l'encodage des options
+    void fillImpactResults(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                           const std::vector<cv::Point2f> &impactsCoordinates, const ProcessingOptions &options,
+                           ImpactResults &results);
+
+    Status tryFillImpactResults(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                const std::vector<cv::Point2f> &impactsCoordinates, const ProcessingOptions &options,
+                                ImpactResults &results);
+
     // Traiter une image pour détecter les impacts
     bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results);
+
+    // Traiter une image pour détecter les impacts avec des options de traitement
+    bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options);
+
+    // Traiter une image brute (YUV, RGBA ou BGR) sans conversion préalable de l'image complète
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results);
+
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options);
+
+    // Variantes avec un contexte réutilisé d'un appel à l'autre : aucune nouvelle image n'est allouée
+    // une fois le contexte initialisé. annotatedImage référence alors context.sheet et reste valide
+    // jusqu'au prochain appel avec le même contexte (context.detachResults() pour la conserver)
+    bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options,
+                         ProcessingContext &context);
+
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options,
+                         ProcessingContext &context);
+
+    // Variantes sans exception : l'erreur est retournée et recopiée dans results.error
+    // (ErrorCode::NONE en cas de succès). Les variantes booléennes lèvent std::runtime_error,
+    // ou retournent false si la bibliothèque est compilée avec SUBVISION_DISABLE_EXCEPTIONS
+    Status tryRetrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options,
+                              ProcessingContext &context);
+
+    Status tryRetrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options,
+                              ProcessingContext &context);
+
+    // Traiter une feuille déjà analysée avec des ellipses cibles connues (coordonnées feuille),
+    // les impacts sont ceux de analysis.impacts
+    bool retrieveImpactsFromSheet(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                  ImpactResults &results);
+
+    bool retrieveImpactsFromSheet(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                  ImpactResults &results, const ProcessingOptions &options);
 }
 
 #endif //SUBVISION_CORE_IMPACT_DETECTION_H
@@ -0,0 +1,33 @@
+#ifndef SUBVISION_CORE_MORPHOLOGY_H
+#define SUBVISION_CORE_MORPHOLOGY_H
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace subvision {
+    // Buffers réutilisables des opérations morphologiques
+    struct MorphologyBuffers {
+        // Minimums / maximums cumulés depuis le début de chaque bloc (passe verticale)
+        cv::Mat prefix;
+        std::vector<uchar> line;
+        std::vector<uchar> border;
+    };
+
+    // Érosion et dilatation d'un masque 8 bits par un carré de côté 2 * radius + 1 (van Herk / Gil-Werman) :
+    // trois comparaisons par pixel et par direction quel que soit le rayon. Résultat identique à
+    // cv::erode / cv::dilate avec l'élément 3x3 par défaut répété radius fois (bords ignorés).
+    // src et dst peuvent être la même image.
+    void erodeRect(const cv::Mat &src, cv::Mat &dst, int radius, MorphologyBuffers &buffers);
+
+    void dilateRect(const cv::Mat &src, cv::Mat &dst, int radius, MorphologyBuffers &buffers);
+
+    void erodeRect(const cv::Mat &src, cv::Mat &dst, int radius);
+
+    void dilateRect(const cv::Mat &src, cv::Mat &dst, int radius);
+
+    // Ouverture puis fermeture (érosion, dilatation de 2 * radius, érosion) : supprime les éléments
+    // et comble les trous plus petits que le carré
+    void openCloseRect(const cv::Mat &src, cv::Mat &dst, int radius, MorphologyBuffers &buffers);
+}
+
+#endif //SUBVISION_CORE_MORPHOLOGY_H
@@ -0,0 +1,88 @@
+#ifndef SUBVISION_CORE_PROCESSING_CONTEXT_H
+#define SUBVISION_CORE_PROCESSING_CONTEXT_H
+
+#include <array>
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "ellipse.h"
+#include "morphology.h"
+#include "resolution_profile.h"
+
+namespace subvision {
+    // Buffers de travail de la détection d'une cible, un jeu par zone pour que les zones
+    // puissent être traitées en parallèle
+    struct TargetBuffers {
+        // Zone et masque des impacts réduits (mode pyramide)
+        cv::Mat coarse;
+        cv::Mat coarseImpacts;
+        cv::Mat value;
+        cv::Mat valueMask;
+        cv::Mat notImpacts;
+        cv::Mat close;
+        cv::Mat filled;
+        MorphologyBuffers morphology;
+        std::vector<std::vector<cv::Point> > contours;
+        std::vector<cv::Point> ellipsePoints;
+    };
+
+    // Contexte de traitement réutilisable : possède les images intermédiaires à la résolution de travail
+    // (2000x2000 par défaut, voir ResolutionProfile) et les réutilise d'un appel à l'autre. Après le premier appel (ou reserve()), le pipeline
+    // n'alloue plus de nouvelle image. Un contexte ne doit servir qu'à un traitement à la fois.
+    struct ProcessingContext {
+        // Détection de la feuille
+        cv::Mat detectionImage;
+        cv::Mat lightness;
+        cv::Mat sheetMask;
+        // Fenêtre en niveaux de gris autour d'un coin (raffinement sous-pixel)
+        cv::Mat cornerWindow;
+        std::vector<cv::Point2f> cornerPoint;
+        // Feuille redressée, homographie de l'image d'origine vers la feuille et plans intermédiaires
+        // des images brutes (RGBA, YUV)
+        cv::Mat sheet;
+        cv::Mat sheetTransform;
+        cv::Mat warped;
+        cv::Mat yuv;
+        cv::Mat uv;
+        // Masque des impacts
+        cv::Mat saturation;
+        cv::Mat impactsScratch;
+        cv::Mat impactsMask;
+        MorphologyBuffers morphology;
+        std::vector<std::vector<cv::Point> > contours;
+        std::vector<cv::Point> ellipsePoints;
+        std::vector<cv::Point2f> impactsCoordinates;
+        // Composantes connexes des impacts
+        cv::Mat impactLabels;
+        cv::Mat impactStats;
+        cv::Mat impactCentroids;
+        std::vector<ImpactBlob> impacts;
+        // Buffers de chaque zone, indexés par zone
+        std::array<TargetBuffers, 5> targets;
+        // Ellipses des cibles en coordonnées de zone puis de feuille
+        std::map<int, Ellipse> targetsEllipsis;
+        std::map<int, Ellipse> sheetTargetsEllipsis;
+
+        ProcessingContext() = default;
+
+        ProcessingContext(const ProcessingContext &) = delete;
+
+        ProcessingContext &operator=(const ProcessingContext &) = delete;
+
+        // Allouer dès maintenant les buffers d'une image BGR (sinon au premier appel)
+        void reserve();
+
+        // Idem pour la taille de feuille d'un profil de résolution
+        void reserve(ResolutionProfile resolution);
+
+        // Détacher la feuille et le masque des impacts : les images déjà retournées (annotatedImage,
+        // SheetAnalysis) ne seront pas réécrites par l'appel suivant, qui les réallouera
+        void detachResults();
+    };
+
+    // Vue de taille size sur un buffer qui ne fait que grandir : les tailles variables
+    // (zone réduite, bande de raffinement) ne provoquent pas de réallocation à chaque appel
+    cv::Mat getBufferView(cv::Mat &buffer, const cv::Size &size, int type);
+}
+
+#endif //SUBVISION_CORE_PROCESSING_CONTEXT_H
@@ -0,0 +1,97 @@
+#ifndef SUBVISION_CORE_RESOLUTION_PROFILE_H
+#define SUBVISION_CORE_RESOLUTION_PROFILE_H
+
+namespace subvision {
+    // Résolution de travail de la feuille redressée
+    enum class ResolutionProfile {
+        // Feuille 800x800 : environ 6 fois moins de pixels
+        FAST,
+        // Feuille 1200x1200 : environ 3 fois moins de pixels
+        BALANCED,
+        // Feuille 2000x2000, résolution historique
+        PRECISE
+    };
+
+    // Côté de la feuille de référence, sur lequel les paramètres ci-dessous ont été réglés
+    constexpr int REFERENCE_SHEET_SIZE = 2000;
+
+    // Paramètres dépendant de la résolution, tous mis à l'échelle du côté de la feuille
+    struct ProcessingProfile {
+        // Côté de la feuille redressée et de l'image de détection de la feuille
+        int sheetSize;
+        // sheetSize / REFERENCE_SHEET_SIZE
+        float scale;
+        // Érosion puis dilatation du masque des impacts
+        int impactMorphologyRadius;
+        // Ouverture / fermeture du masque des cibles
+        int targetCloseIterations;
+        // Réduction du niveau grossier en mode pyramide, et itérations à ce niveau puis dans la bande
+        int pyramidFactor;
+        int pyramidCoarseIterations;
+        int pyramidRefineIterations;
+        // Demi-côté de la première fenêtre de recherche d'une cible (visuel d'environ 335 pixels de diamètre
+        // à la résolution de référence)
+        int targetSearchRadius;
+    };
+
+    // Arrondi d'une valeur de référence mise à l'échelle, au moins 1
+    constexpr int scaleProfileValue(const int value, const int sheetSize) {
+        const int scaled = (2 * value * sheetSize + REFERENCE_SHEET_SIZE) / (2 * REFERENCE_SHEET_SIZE);
+        return scaled < 1 ? 1 : scaled;
+    }
+
+    constexpr ProcessingProfile makeProfile(const int sheetSize) {
+        const int pyramidFactor = scaleProfileValue(4, sheetSize);
+        const int targetCloseIterations = scaleProfileValue(10, sheetSize);
+        return {
+            sheetSize,
+            static_cast<float>(sheetSize) / static_cast<float>(REFERENCE_SHEET_SIZE),
+            scaleProfileValue(2, sheetSize),
+            targetCloseIterations,
+            pyramidFactor,
+            (targetCloseIterations + pyramidFactor - 1) / pyramidFactor,
+            scaleProfileValue(2, sheetSize),
+            scaleProfileValue(300, sheetSize)
+        };
+    }
+
+    // Profils calculés à la compilation pour les tailles courantes
+    template<int SheetSize>
+    inline constexpr ProcessingProfile PROFILE = makeProfile(SheetSize);
+
+    inline constexpr const ProcessingProfile &FAST_PROFILE = PROFILE<800>;
+    inline constexpr const ProcessingProfile &BALANCED_PROFILE = PROFILE<1200>;
+    inline constexpr const ProcessingProfile &PRECISE_PROFILE = PROFILE<REFERENCE_SHEET_SIZE>;
+
+    static_assert(PRECISE_PROFILE.impactMorphologyRadius == 2 && PRECISE_PROFILE.targetCloseIterations == 10 &&
+                  PRECISE_PROFILE.pyramidFactor == 4 && PRECISE_PROFILE.pyramidCoarseIterations == 3 &&
+                  PRECISE_PROFILE.pyramidRefineIterations == 2 && PRECISE_PROFILE.targetSearchRadius == 300,
+                  "The precise profile must keep the historical parameters");
+
+    constexpr const ProcessingProfile &getProcessingProfile(const ResolutionProfile resolution) {
+        switch (resolution) {
+            case ResolutionProfile::FAST:
+                return FAST_PROFILE;
+            case ResolutionProfile::BALANCED:
+                return BALANCED_PROFILE;
+            default:
+                return PRECISE_PROFILE;
+        }
+    }
+
+    // Profil d'une feuille déjà redressée, d'après son côté
+    constexpr ProcessingProfile getProcessingProfile(const int sheetSize) {
+        switch (sheetSize) {
+            case 800:
+                return FAST_PROFILE;
+            case 1200:
+                return BALANCED_PROFILE;
+            case REFERENCE_SHEET_SIZE:
+                return PRECISE_PROFILE;
+            default:
+                return makeProfile(sheetSize);
+        }
+    }
+}
+
+#endif //SUBVISION_CORE_RESOLUTION_PROFILE_H
@@ -0,0 +1,198 @@
+#ifndef SUBVISION_CORE_RESULT_H
+#define SUBVISION_CORE_RESULT_H
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "trace.h"
+#include "types.h"
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#if !defined(__cpp_lib_expected)
+#include <variant>
+#endif
+
+namespace subvision {
+    // Message par défaut d'un code d'erreur
+    inline const char *getErrorMessage(const ErrorCode code) {
+        switch (code) {
+            case ErrorCode::NONE:
+                return "No error";
+            case ErrorCode::INVALID_IMAGE:
+                return "Invalid image";
+            case ErrorCode::NO_SHEET:
+                return "No valid contour found";
+            case ErrorCode::DEGENERATE_HOMOGRAPHY:
+                return "Degenerate sheet corners";
+            case ErrorCode::INVALID_TARGET_ELLIPSE:
+                return "Problem during visual detection";
+            case ErrorCode::ENCODING_FAILED:
+                return "Unable to encode the annotated image";
+            case ErrorCode::INTERNAL:
+                break;
+        }
+        return "Internal error";
+    }
+
+    inline ProcessingError makeError(const ErrorCode code, const int zone = -1) {
+        return ProcessingError{code, zone, getErrorMessage(code)};
+    }
+
+#if defined(__cpp_lib_expected)
+    // Valeur ou erreur typée, sans exception
+    template<typename T>
+    using Result = std::expected<T, ProcessingError>;
+
+    using Unexpected = std::unexpected<ProcessingError>;
+#else
+    // Sous-ensemble de std::expected pour les chaînes de compilation sans <expected> (emscripten 2.0.x)
+    class Unexpected {
+    public:
+        explicit Unexpected(ProcessingError error) : value(std::move(error)) {
+        }
+
+        const ProcessingError &error() const {
+            return value;
+        }
+
+    private:
+        ProcessingError value;
+    };
+
+    template<typename T>
+    class Result {
+    public:
+        Result(T value) : storage(std::in_place_index<0>, std::move(value)) {
+        }
+
+        Result(Unexpected error) : storage(std::in_place_index<1>, error.error()) {
+        }
+
+        bool has_value() const {
+            return storage.index() == 0;
+        }
+
+        explicit operator bool() const {
+            return has_value();
+        }
+
+        T &value() {
+            return *std::get_if<0>(&storage);
+        }
+
+        const T &value() const {
+            return *std::get_if<0>(&storage);
+        }
+
+        T &operator*() {
+            return value();
+        }
+
+        const T &operator*() const {
+            return value();
+        }
+
+        T *operator->() {
+            return &value();
+        }
+
+        const T *operator->() const {
+            return &value();
+        }
+
+        const ProcessingError &error() const {
+            return *std::get_if<1>(&storage);
+        }
+
+    private:
+        std::variant<T, ProcessingError> storage;
+    };
+
+    template<>
+    class Result<void> {
+    public:
+        Result() = default;
+
+        Result(Unexpected error) : failed(true), failure(error.error()) {
+        }
+
+        bool has_value() const {
+            return !failed;
+        }
+
+        explicit operator bool() const {
+            return has_value();
+        }
+
+        const ProcessingError &error() const {
+            return failure;
+        }
+
+    private:
+        bool failed = false;
+        ProcessingError failure;
+    };
+#endif
+
+    // Succès ou erreur d'une étape sans valeur
+    using Status = Result<void>;
+
+    inline Unexpected fail(const ErrorCode code, const int zone = -1) {
+        return Unexpected(makeError(code, zone));
+    }
+
+    // Échec d'un appel invalide (arguments, configuration) : exception std::runtime_error, ou arrêt
+    // si la bibliothèque est compilée sans exceptions (SUBVISION_DISABLE_EXCEPTIONS)
+    [[noreturn]] inline void raiseError(const std::string &message) {
+#ifdef SUBVISION_DISABLE_EXCEPTIONS
+        SUBVISION_LOG_ERROR(message);
+        std::abort();
+#else
+        throw std::runtime_error(message);
+#endif
+    }
+
+    // Valeur d'un résultat pour les API historiques qui signalent les erreurs par exception
+    template<typename T>
+    T valueOrRaise(Result<T> &&result) {
+        if (!result) {
+            raiseError(result.error().message);
+        }
+        return std::move(*result);
+    }
+
+    // Statut d'une API historique retournant un booléen : exception en cas d'erreur,
+    // false sans exceptions
+    inline bool checkStatus(const Status &status) {
+        if (status) {
+            return true;
+        }
+#ifdef SUBVISION_DISABLE_EXCEPTIONS
+        SUBVISION_LOG_WARNING(status.error().message);
+        return false;
+#else
+        raiseError(status.error().message);
+#endif
+    }
+
+    // Appel d'une étape qui peut lever une exception (OpenCV, code de l'application), convertie en
+    // erreur INTERNAL. Sans exceptions, simple appel
+    template<typename Function>
+    Status catchErrors(Function &&function) {
+#ifdef SUBVISION_DISABLE_EXCEPTIONS
+        return function();
+#else
+        try {
+            return function();
+        } catch (const std::exception &e) {
+            return Unexpected(ProcessingError{ErrorCode::INTERNAL, -1, e.what()});
+        }
+#endif
+    }
+}
+
+#endif //SUBVISION_CORE_RESULT_H
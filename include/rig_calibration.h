@@ -0,0 +1,87 @@
+#ifndef SUBVISION_CORE_RIG_CALIBRATION_H
+#define SUBVISION_CORE_RIG_CALIBRATION_H
+
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "corner_tracking.h"
+#include "processing_context.h"
+#include "result.h"
+#include "types.h"
+
+namespace subvision {
+    struct RigCalibrationOptions {
+        // Options appliquées à la détection (calibrage) et au calcul des scores
+        ProcessingOptions processing;
+        // Corrélation minimale (TM_CCOEFF_NORMED) de chaque coin pour utiliser la géométrie enregistrée
+        float minMatchScore = 0.8f;
+        // Fenêtre de recherche des coins autour de leur position calibrée, en pixels de l'image source
+        int searchRadius = 8;
+        // Demi-taille du motif de référence autour de chaque coin, en pixels de l'image source
+        int patchRadius = 16;
+        // Déplacement maximal d'un coin (pixels source) pour que la géométrie enregistrée reste valable
+        float maxCornerShift = 2.0f;
+        // Recalibrer sur l'image quand la vérification échoue (sinon simple détection complète)
+        bool recalibrate = true;
+    };
+
+    // Poste de tir à caméra fixe : la feuille et les cibles sont détectées une fois (calibrage), l'homographie
+    // est précalculée sous forme de tables cv::remap en virgule fixe. Chaque image suivante est seulement
+    // vérifiée par corrélation autour des coins ; la détection complète n'est relancée que si un coin a bougé
+    class RigCalibration {
+    public:
+        explicit RigCalibration(const RigCalibrationOptions &options = RigCalibrationOptions());
+
+        // Calibrer sur une image BGR du poste : détection de la feuille et des cibles, tables de remap
+        Status calibrate(const cv::Mat &image);
+
+        // Traiter une image BGR avec la géométrie enregistrée si les coins sont retrouvés, sinon par
+        // détection complète. Retourne false en cas d'erreur (results.error). Les buffers sont réutilisés
+        // d'une image à l'autre : annotatedImage est réécrite par l'image suivante
+        bool processImage(const cv::Mat &image, ImpactResults &results);
+
+        // Oublier le calibrage
+        void reset();
+
+        bool isCalibrated() const;
+
+        // La dernière image a-t-elle été traitée avec la géométrie enregistrée
+        bool usedCalibration() const;
+
+        // Corrélation du coin le moins bien retrouvé sur la dernière image vérifiée
+        float verificationScore() const;
+
+        // Coins de la feuille calibrée (haut-gauche, haut-droite, bas-droite, bas-gauche)
+        const std::vector<cv::Point2f> &corners() const;
+
+        // Homographie de l'image vers la feuille redressée (côté du profil de résolution)
+        const cv::Mat &transform() const;
+
+        // Ellipses des cibles en coordonnées feuille
+        const std::map<int, Ellipse> &targets() const;
+
+    private:
+        // Détection complète ; le calibrage précédent n'est remplacé qu'en cas de succès
+        Status detect(const cv::Mat &image, SheetAnalysis &analysis);
+
+        bool verify(const cv::Mat &image);
+
+        RigCalibrationOptions options;
+        cv::Size imageSize;
+        std::vector<cv::Point2f> sheetCorners;
+        cv::Mat sheetTransform;
+        std::map<int, Ellipse> sheetTargets;
+        CornerPatches patches;
+        // Tables de cv::remap (CV_16SC2 et CV_16UC1) de la feuille vers l'image calibrée
+        cv::Mat mapXY;
+        cv::Mat mapInterpolation;
+        float score = 0;
+        bool calibrated = false;
+        bool cached = false;
+
+        // Buffers de travail réutilisés d'une image à l'autre
+        ProcessingContext context;
+    };
+}
+
+#endif //SUBVISION_CORE_RIG_CALIBRATION_H
@@ -0,0 +1,89 @@
+#ifndef SUBVISION_CORE_SCORING_H
+#define SUBVISION_CORE_SCORING_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace subvision {
+    // Règles de score : distance réelle (mm) au centre de la cible
+    constexpr int MAXIMUM_IMPACT_DISTANCE = 48;
+    constexpr int MAXIMUM_SCORE = 570;
+    // Rayon réel (mm) de l'ellipse cible agrandie de TARGET_SCORING_GROWTH
+    constexpr float TARGET_REAL_RADIUS = 45.0f;
+    constexpr float TARGET_SCORING_GROWTH = 1.8f;
+
+    constexpr int computeScore(const int distance) {
+        if (distance > MAXIMUM_IMPACT_DISTANCE) {
+            return 0;
+        }
+        if (distance <= 0) {
+            return MAXIMUM_SCORE;
+        }
+        if (distance <= 5) {
+            return MAXIMUM_SCORE - distance * 6;
+        }
+        return MAXIMUM_SCORE - 30 - (distance - 5) * 3;
+    }
+
+    // Score de chaque distance de 0 à MAXIMUM_IMPACT_DISTANCE + 1 (dernière case : hors cible)
+    constexpr std::array<int, MAXIMUM_IMPACT_DISTANCE + 2> makeScoreTable() {
+        std::array<int, MAXIMUM_IMPACT_DISTANCE + 2> table{};
+        for (int distance = 0; distance < static_cast<int>(table.size()); ++distance) {
+            table[distance] = computeScore(distance);
+        }
+        return table;
+    }
+
+    constexpr std::array<int, MAXIMUM_IMPACT_DISTANCE + 2> SCORE_TABLE = makeScoreTable();
+
+    constexpr int lookupScore(const int distance) {
+        return SCORE_TABLE[distance <= 0 ? 0 : distance > MAXIMUM_IMPACT_DISTANCE ? MAXIMUM_IMPACT_DISTANCE + 1
+                                                                                  : distance];
+    }
+
+    // Ellipses cibles en structure de tableaux, coordonnées feuille (targetCoordinatesToSheetCoordinates).
+    // Les zones doivent être ajoutées dans l'ordre croissant : à égalité de distance, la première l'emporte
+    struct TargetBatch {
+        std::vector<int> zones;
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        // Axes complets de l'ellipse détectée (l'orientation n'intervient pas dans le score)
+        std::vector<float> width;
+        std::vector<float> height;
+
+        void add(int zone, float x, float y, float axisWidth, float axisHeight);
+
+        std::size_t size() const;
+
+        void clear();
+    };
+
+    // Résultats par impact, dans l'ordre des impacts. Les buffers sont réutilisés d'un lot à l'autre
+    struct ScoreBatch {
+        std::vector<int> zones;
+        // Distance réelle arrondie au mm
+        std::vector<int> distances;
+        std::vector<int> scores;
+        // Angle en degrés, même convention que Impact::angle
+        std::vector<float> angles;
+        // Carré de la distance à la cible la plus proche (travail)
+        std::vector<float> nearest;
+
+        std::size_t size() const;
+    };
+
+    // Scorer un lot d'impacts (coordonnées feuille) sans image ni dessin : mêmes zones, distances, scores et
+    // angles que scoreImpacts, à l'arrondi flottant près de la distance. La distance au bord de l'ellipse est
+    // calculée sans trigonométrie et le score lu dans SCORE_TABLE ; seul l'angle demande un atan2.
+    // Sans cible, les impacts sont en zone SUBVISION_ZONE_UNDEFINED avec un score nul.
+    // Pointeurs et nombre d'impacts plutôt que std::span : l'en-tête reste compilable en C++17 (emscripten 2.0.x)
+    void scoreImpactBatch(const float *x, const float *y, std::size_t count, const TargetBatch &targets,
+                          ScoreBatch &results);
+
+    // Idem avec des tableaux de coordonnées, limités au plus court
+    void scoreImpactBatch(const std::vector<float> &x, const std::vector<float> &y, const TargetBatch &targets,
+                          ScoreBatch &results);
+}
+
+#endif //SUBVISION_CORE_SCORING_H
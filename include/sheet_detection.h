@@ -5,10 +5,61 @@
 #ifndef SHEET_DETECTION_H
 #define SHEET_DETECTION_H
 #include <opencv2/core/types.hpp>
+#include "processing_context.h"
+#include "result.h"
+#include "types.h"
 
 namespace subvision {
     cv::Mat getSheetPicture(const cv::Mat& image) ;
     std::vector<cv::Point2f> getSheetCoordinates(const cv::Mat& sheet_mat) ;
+    // Variantes pour une image brute (YUV ou RGBA), sans conversion préalable de l'image complète
+    cv::Mat getSheetPicture(const ImageBuffer& image) ;
+    std::vector<cv::Point2f> getSheetCoordinates(const ImageBuffer& image) ;
+    // Homographie des quatre coins en pixels vers la feuille redressée
+    cv::Mat getSheetTransform(const std::vector<cv::Point2f>& corners) ;
+    // Redresser la feuille à partir de ses quatre coins en pixels
+    cv::Mat warpSheet(const cv::Mat& image, const std::vector<cv::Point2f>& corners) ;
+    void warpSheet(const cv::Mat& image, const std::vector<cv::Point2f>& corners, cv::Mat& dst) ;
+    // Variantes avec les buffers d'un contexte réutilisable : la feuille retournée est context.sheet,
+    // réécrite par l'appel suivant avec le même contexte
+    cv::Mat getSheetPicture(const cv::Mat& image, ProcessingContext& context) ;
+    std::vector<cv::Point2f> getSheetCoordinates(const cv::Mat& sheet_mat, ProcessingContext& context) ;
+    cv::Mat getSheetPicture(const ImageBuffer& image, ProcessingContext& context) ;
+    std::vector<cv::Point2f> getSheetCoordinates(const ImageBuffer& image, ProcessingContext& context) ;
+    // Variantes sans exception : NO_SHEET, INVALID_IMAGE ou DEGENERATE_HOMOGRAPHY en cas d'échec.
+    // Les fonctions précédentes lèvent std::runtime_error avec le message de l'erreur.
+    // En mode PROXY, le contour est cherché sur une image d'environ 512 pixels et les coins sont raffinés
+    // à la résolution d'origine (voir SheetDetectionMode). resolution fixe le côté de la feuille redressée et,
+    // en mode FULL_RESOLUTION, celui de l'image de détection
+    Result<std::vector<cv::Point2f>> tryGetSheetCoordinates(const cv::Mat& sheet_mat, ProcessingContext& context,
+        SheetDetectionMode mode = SheetDetectionMode::FULL_RESOLUTION,
+        ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    Result<std::vector<cv::Point2f>> tryGetSheetCoordinates(const ImageBuffer& image, ProcessingContext& context,
+        SheetDetectionMode mode = SheetDetectionMode::FULL_RESOLUTION,
+        ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    Result<cv::Mat> tryGetSheetPicture(const cv::Mat& image, ProcessingContext& context,
+        SheetDetectionMode mode = SheetDetectionMode::FULL_RESOLUTION,
+        ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    Result<cv::Mat> tryGetSheetPicture(const ImageBuffer& image, ProcessingContext& context,
+        SheetDetectionMode mode = SheetDetectionMode::FULL_RESOLUTION,
+        ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    Result<cv::Mat> tryGetSheetTransform(const std::vector<cv::Point2f>& corners) ;
+    // Homographie vers une feuille redressée de taille sheetSize
+    Result<cv::Mat> tryGetSheetTransform(const std::vector<cv::Point2f>& corners, const cv::Size& sheetSize) ;
+    Status tryWarpSheet(const cv::Mat& image, const std::vector<cv::Point2f>& corners, cv::Mat& dst,
+                        ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    // Homographie de l'image d'origine vers la tuile d'une zone de la feuille du profil resolution réduite d'un
+    // facteur scale (transform : homographie vers la feuille de ce profil)
+    cv::Mat getSheetZoneTransform(const cv::Mat& transform, int zone, double scale,
+                                  ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    // Tuile d'une zone redressée directement depuis l'image d'origine à la résolution voulue, sans passer par
+    // la feuille complète (transform : homographie de tryGetSheetTransform vers la feuille du profil resolution)
+    void warpSheetZone(const cv::Mat& image, const cv::Mat& transform, int zone, double scale, cv::Mat& dst,
+                       ResolutionProfile resolution = ResolutionProfile::PRECISE) ;
+    // Idem pour un rectangle quelconque de la feuille, redressé à la taille size
+    cv::Mat getSheetRegionTransform(const cv::Mat& transform, const cv::Rect& region, const cv::Size& size) ;
+    void warpSheetRegion(const cv::Mat& image, const cv::Mat& transform, const cv::Rect& region, const cv::Size& size,
+                         cv::Mat& dst) ;
 }
 
 #endif //SHEET_DETECTION_H
@@ -2,11 +2,23 @@
 #define SUBVISION_CORE_H
 
 #include "constants.h"
+#include "ellipse.h"
+#include "resolution_profile.h"
 #include "types.h"
+#include "result.h"
 #include "utils.h"
+#include "scoring.h"
+#include "image_buffer.h"
+#include "processing_context.h"
 #include "image_processing.h"
+#include "morphology.h"
+#include "annotation.h"
 #include "target_detection.h"
 #include "impact_detection.h"
 #include "sheet_detection.h"
+#include "batch_processing.h"
+#include "corner_tracking.h"
+#include "video_session.h"
+#include "rig_calibration.h"
 
 #endif //SUBVISION_CORE_H
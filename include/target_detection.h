@@ -3,21 +3,86 @@
 
 #include <opencv2/opencv.hpp>
 #include <map>
+#include "processing_context.h"
+#include "result.h"
 #include "types.h"
+#include "thread_pool.h"
 
 namespace subvision {
     // Obtenir l'ellipse cible
     Ellipse getTargetEllipse(const cv::Mat &mat);
 
+    // Obtenir l'ellipse cible avec un masque des impacts déjà calculé
+    Ellipse getTargetEllipse(const cv::Mat &mat, const cv::Mat &impactsMask);
+
+    // Obtenir l'ellipse cible en mode pyramide (détection réduite puis raffinement à pleine résolution)
+    Ellipse getTargetEllipsePyramid(const cv::Mat &mat, const cv::Mat &impactsMask);
+
+    // Variantes avec les buffers réutilisables d'une zone
+    Ellipse getTargetEllipse(const cv::Mat &mat, const cv::Mat &impactsMask, TargetBuffers &buffers);
+
+    Ellipse getTargetEllipsePyramid(const cv::Mat &mat, const cv::Mat &impactsMask, TargetBuffers &buffers);
+
     // Obtenir l'ellipse cible pour une zone
     Ellipse getTargetEllipseForZone(const cv::Mat &image, int zone);
 
+    // Obtenir l'ellipse cible pour une zone d'une feuille analysée
+    Ellipse getTargetEllipseForZone(const SheetAnalysis &analysis, int zone,
+                                    TargetDetectionMode mode = TargetDetectionMode::FULL_RESOLUTION);
+
+    Ellipse getTargetEllipseForZone(const SheetAnalysis &analysis, int zone, TargetDetectionMode mode,
+                                    TargetBuffers &buffers);
+
+    // Fenêtre de recherche de la cible d'une zone, centrée sur sa position attendue et agrandie growth fois,
+    // limitée à la zone (coordonnées de la feuille)
+    cv::Rect getTargetSearchWindow(const cv::Size &sheetSize, int zone, int growth);
+
+    // Variante sans exception : INVALID_TARGET_ELLIPSE avec la zone en cas d'échec. La cible est d'abord
+    // cherchée dans une fenêtre autour de sa position attendue, élargie seulement en cas d'échec
+    Result<Ellipse> tryGetTargetEllipseForZone(const SheetAnalysis &analysis, int zone, TargetDetectionMode mode,
+                                               TargetBuffers &buffers);
+
     // Obtenir les ellipses pour toutes les cibles
     std::map<int, Ellipse> getTargetsEllipse(const cv::Mat &image);
 
+    // Obtenir les ellipses pour toutes les cibles, une zone par tâche du pool
+    std::map<int, Ellipse> getTargetsEllipse(const cv::Mat &image, ThreadPool &pool);
+
+    // Obtenir les ellipses pour toutes les cibles d'une feuille analysée
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis,
+                                             TargetDetectionMode mode = TargetDetectionMode::FULL_RESOLUTION);
+
+    // Obtenir les ellipses pour toutes les cibles d'une feuille analysée, une zone par tâche du pool
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, ThreadPool &pool,
+                                             TargetDetectionMode mode = TargetDetectionMode::FULL_RESOLUTION);
+
+    // Obtenir les ellipses pour toutes les cibles d'une feuille analysée selon les options de traitement
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options);
+
+    // Idem avec les buffers de zone du contexte
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options,
+                                             ProcessingContext &context);
+
+    // Variante sans exception : première zone en échec dans l'ordre de TARGET_ZONES
+    Result<std::map<int, Ellipse>> tryGetTargetsEllipse(const SheetAnalysis &analysis,
+                                                        const ProcessingOptions &options,
+                                                        ProcessingContext &context);
+
+    // Idem dans ellipses (coordonnées de zone), dont les nœuds sont réutilisés d'un appel à l'autre
+    Status tryGetTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options,
+                                ProcessingContext &context, std::map<int, Ellipse> &ellipses);
+
     // Convertir les coordonnées de cible en coordonnées de feuille
     std::map<int, Ellipse> targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses);
 
+    // Idem pour une feuille redressée de taille sheetSize (profil de résolution autre que PRECISE)
+    std::map<int, Ellipse> targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses,
+                                                               const cv::Size &sheetSize);
+
+    // Idem dans sheetEllipses, dont les nœuds sont réutilisés
+    void targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses, const cv::Size &sheetSize,
+                                             std::map<int, Ellipse> &sheetEllipses);
+
     // Dessiner les cibles sur l'image
     void drawTargets(const std::map<int, Ellipse> &coordinates, cv::Mat &sheetMat);
 
@@ -0,0 +1,53 @@
+#ifndef SUBVISION_CORE_THREAD_POOL_H
+#define SUBVISION_CORE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace subvision {
+    // Pool de threads réutilisable, partagé entre plusieurs appels de traitement
+    class ThreadPool {
+    public:
+        // Un nombre de workers à 0 utilise le nombre de coeurs disponibles
+        explicit ThreadPool(std::size_t workerCount = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Nombre de workers du pool
+        std::size_t size() const;
+
+        // Soumettre une tâche, le résultat (ou l'exception) est récupéré via le future
+        template<typename F>
+        std::future<std::invoke_result_t<std::decay_t<F> > > submit(F &&task) {
+            using Result = std::invoke_result_t<std::decay_t<F> >;
+            auto packagedTask = std::make_shared<std::packaged_task<Result()> >(std::forward<F>(task));
+            std::future<Result> future = packagedTask->get_future();
+            enqueue([packagedTask]() { (*packagedTask)(); });
+            return future;
+        }
+
+    private:
+        void enqueue(std::function<void()> job);
+
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()> > jobs;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+    };
+}
+
+#endif //SUBVISION_CORE_THREAD_POOL_H
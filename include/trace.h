@@ -0,0 +1,144 @@
+#ifndef SUBVISION_CORE_TRACE_H
+#define SUBVISION_CORE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Niveaux de log, les messages sous SUBVISION_LOG_LEVEL ne sont pas compilés
+#define SUBVISION_LOG_LEVEL_TRACE 0
+#define SUBVISION_LOG_LEVEL_DEBUG 1
+#define SUBVISION_LOG_LEVEL_INFO 2
+#define SUBVISION_LOG_LEVEL_WARNING 3
+#define SUBVISION_LOG_LEVEL_ERROR 4
+#define SUBVISION_LOG_LEVEL_NONE 5
+
+#ifndef SUBVISION_LOG_LEVEL
+#ifdef NDEBUG
+#define SUBVISION_LOG_LEVEL SUBVISION_LOG_LEVEL_NONE
+#else
+#define SUBVISION_LOG_LEVEL SUBVISION_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+namespace subvision {
+    // Casse mixte pour éviter les macros DEBUG/ERROR définies par certaines plateformes
+    enum class LogLevel {
+        Trace = SUBVISION_LOG_LEVEL_TRACE,
+        Debug = SUBVISION_LOG_LEVEL_DEBUG,
+        Info = SUBVISION_LOG_LEVEL_INFO,
+        Warning = SUBVISION_LOG_LEVEL_WARNING,
+        Error = SUBVISION_LOG_LEVEL_ERROR
+    };
+
+    // Écrire un message de log (sans flush)
+    void logMessage(LogLevel level, const std::string &message);
+
+    // Intervalle mesuré par un TraceScope
+    struct TraceEvent {
+        std::string name;
+        std::int64_t startMicros;
+        std::int64_t durationMicros;
+        std::uint32_t threadId;
+        int depth;
+    };
+
+    // Collecteur des intervalles de trace, désactivé par défaut
+    class Tracer {
+    public:
+        static Tracer &instance();
+
+        void setEnabled(bool enabled);
+
+        bool isEnabled() const;
+
+        void record(TraceEvent event);
+
+        void clear();
+
+        std::vector<TraceEvent> events() const;
+
+        // Temps écoulé depuis la création du tracer
+        std::int64_t nowMicros() const;
+
+        // Export au format Chrome trace (chrome://tracing, Perfetto)
+        void exportChromeTrace(std::ostream &out) const;
+
+        // Export JSON simple : une entrée par intervalle
+        void exportJson(std::ostream &out) const;
+
+    private:
+        Tracer();
+
+        std::atomic<bool> enabled{false};
+        const std::chrono::steady_clock::time_point epoch;
+        mutable std::mutex mutex;
+        std::vector<TraceEvent> recordedEvents;
+    };
+
+    // Intervalle de trace lié à une portée, imbriqué dans l'intervalle courant du thread
+    class TraceScope {
+    public:
+        explicit TraceScope(const char *name);
+
+        ~TraceScope();
+
+        TraceScope(const TraceScope &) = delete;
+
+        TraceScope &operator=(const TraceScope &) = delete;
+
+    private:
+        const char *name;
+        std::int64_t startMicros = 0;
+        int depth = 0;
+        bool active;
+    };
+}
+
+#define SUBVISION_TRACE_CONCAT_INNER(a, b) a##b
+#define SUBVISION_TRACE_CONCAT(a, b) SUBVISION_TRACE_CONCAT_INNER(a, b)
+
+#ifdef SUBVISION_ENABLE_TRACING
+#define SUBVISION_TRACE_SCOPE(name) \
+    const ::subvision::TraceScope SUBVISION_TRACE_CONCAT(subvisionTraceScope, __LINE__)(name)
+#else
+#define SUBVISION_TRACE_SCOPE(name) ((void) 0)
+#endif
+
+#define SUBVISION_LOG_MESSAGE(level, message) \
+    do { \
+        std::ostringstream subvisionLogStream; \
+        subvisionLogStream << message; \
+        ::subvision::logMessage(level, subvisionLogStream.str()); \
+    } while (0)
+
+#if SUBVISION_LOG_LEVEL <= SUBVISION_LOG_LEVEL_DEBUG
+#define SUBVISION_LOG_DEBUG(message) SUBVISION_LOG_MESSAGE(::subvision::LogLevel::Debug, message)
+#else
+#define SUBVISION_LOG_DEBUG(message) ((void) 0)
+#endif
+
+#if SUBVISION_LOG_LEVEL <= SUBVISION_LOG_LEVEL_INFO
+#define SUBVISION_LOG_INFO(message) SUBVISION_LOG_MESSAGE(::subvision::LogLevel::Info, message)
+#else
+#define SUBVISION_LOG_INFO(message) ((void) 0)
+#endif
+
+#if SUBVISION_LOG_LEVEL <= SUBVISION_LOG_LEVEL_WARNING
+#define SUBVISION_LOG_WARNING(message) SUBVISION_LOG_MESSAGE(::subvision::LogLevel::Warning, message)
+#else
+#define SUBVISION_LOG_WARNING(message) ((void) 0)
+#endif
+
+#if SUBVISION_LOG_LEVEL <= SUBVISION_LOG_LEVEL_ERROR
+#define SUBVISION_LOG_ERROR(message) SUBVISION_LOG_MESSAGE(::subvision::LogLevel::Error, message)
+#else
+#define SUBVISION_LOG_ERROR(message) ((void) 0)
+#endif
+
+#endif //SUBVISION_CORE_TRACE_H
@@ -1,11 +1,15 @@
 #ifndef SUBVISION_CORE_TYPES_H
 #define SUBVISION_CORE_TYPES_H
 
+#include <map>
 #include <opencv2/opencv.hpp>
-#include <tuple>
+#include <string>
+#include <vector>
+#include "ellipse.h"
+#include "resolution_profile.h"
 
 namespace subvision {
-    using Ellipse = std::tuple<cv::Point2f, cv::Size2f, float>;
+    class ThreadPool;
 
     struct Impact {
         int distance;
@@ -18,9 +22,173 @@ namespace subvision {
             : distance(distance), score(score), zone(zone), angle(angle), count(count) {}
     };
 
+    // Type de primitive d'annotation
+    enum class OverlayPrimitiveType {
+        ELLIPSE,
+        LINE,
+        // Disque plein
+        POINT,
+        // Texte Hershey (FONT_HERSHEY_SIMPLEX)
+        LABEL
+    };
+
+    // Primitive d'annotation en coordonnées feuille (côté du profil de résolution, 2000 par défaut),
+    // à dessiner par le client à sa résolution
+    struct OverlayPrimitive {
+        OverlayPrimitiveType type = OverlayPrimitiveType::POINT;
+        // Centre (ellipse, point), début (ligne) ou coin bas-gauche du texte (label)
+        cv::Point2f position;
+        // Fin d'une ligne
+        cv::Point2f end;
+        // Demi-axes d'une ellipse
+        cv::Size2f axes;
+        // Angle d'une ellipse en degrés
+        float angle = 0;
+        // Rayon d'un point ou échelle de la police d'un label
+        float size = 0;
+        // Épaisseur du trait en pixels feuille, -1 pour un point plein
+        int thickness = 1;
+        // Couleur BGR
+        cv::Scalar color;
+        std::string text;
+    };
+
+    // Cause d'échec d'un traitement
+    enum class ErrorCode {
+        NONE,
+        // Image vide ou dans un format non pris en charge
+        INVALID_IMAGE,
+        // Aucune feuille trouvée dans l'image
+        NO_SHEET,
+        // Coins de la feuille alignés ou confondus, l'homographie n'est pas inversible
+        DEGENERATE_HOMOGRAPHY,
+        // Ellipse de la cible d'une zone introuvable ou trop déformée
+        INVALID_TARGET_ELLIPSE,
+        // Encodage de l'image annotée impossible
+        ENCODING_FAILED,
+        // Erreur inattendue remontée par OpenCV ou par l'application
+        INTERNAL
+    };
+
+    struct ProcessingError {
+        ErrorCode code = ErrorCode::NONE;
+        // Zone de la cible en cause (INVALID_TARGET_ELLIPSE), -1 sinon
+        int zone = -1;
+        std::string message;
+    };
+
     struct ImpactResults {
+        // Feuille annotée (AnnotationMode::RASTER), feuille sans annotation (VECTOR) ou vide (NONE)
         cv::Mat annotatedImage;
         std::vector<Impact> impacts;
+        // Ellipses cibles en coordonnées feuille, par zone
+        std::map<int, Ellipse> targets;
+        // Annotation vectorielle, remplie uniquement en mode AnnotationMode::VECTOR
+        std::vector<OverlayPrimitive> overlay;
+        // Image annotée encodée (EncodingOptions), vide si aucun encodage n'est demandé
+        std::vector<uchar> encodedImage;
+        // Cause de l'échec du traitement, code ErrorCode::NONE en cas de succès
+        ProcessingError error;
+    };
+
+    // Impact extrait du masque : ellipse de mêmes moments d'ordre 2 que sa composante connexe
+    struct ImpactBlob {
+        cv::Point2f center;
+        // Axes complets, width est le grand axe
+        cv::Size2f axes;
+        // Orientation du grand axe en degrés
+        float angle = 0;
+        // Nombre de pixels de la composante
+        int area = 0;
+    };
+
+    // Analyse d'une feuille redressée, calculée une seule fois et partagée entre les étapes
+    struct SheetAnalysis {
+        cv::Mat sheet;
+        cv::Mat impactsMask;
+        // Impacts extraits lors du calcul du masque
+        std::vector<ImpactBlob> impacts;
+        // Image d'origine (BGR) et homographie vers la feuille, si elles sont encore disponibles : les tuiles
+        // réduites des zones (mode pyramide) en sont tirées directement
+        cv::Mat source;
+        cv::Mat transform;
+    };
+
+    // Format des pixels d'une image fournie par la caméra ou l'application hôte
+    enum class PixelFormat {
+        BGR,
+        RGBA,
+        // YUV 4:2:0 : plan Y puis plan UV entrelacé (NV12) ou VU entrelacé (NV21)
+        NV12,
+        NV21,
+        // YUV 4:2:0 : plans Y, U et V séparés
+        I420
+    };
+
+    // Image brute décrite par ses plans et leur pas en octets, les pixels ne sont pas copiés
+    struct ImageBuffer {
+        PixelFormat format = PixelFormat::BGR;
+        int width = 0;
+        int height = 0;
+        // Un plan pour BGR/RGBA, Y et UV pour NV12/NV21, Y, U et V pour I420
+        const uchar *planes[3] = {nullptr, nullptr, nullptr};
+        size_t strides[3] = {0, 0, 0};
+    };
+
+    // Mode de détection des ellipses cibles
+    enum class TargetDetectionMode {
+        FULL_RESOLUTION,
+        // Détection sur une image réduite 4x puis raffinement dans une bande à pleine résolution
+        PYRAMID
+    };
+
+    // Mode de détection de la feuille
+    enum class SheetDetectionMode {
+        // Contour cherché sur l'image redimensionnée au côté du profil de résolution
+        FULL_RESOLUTION,
+        // Contour cherché sur une image réduite (~512 px), coins raffinés au sous-pixel dans une petite
+        // fenêtre à la résolution d'origine : coût presque indépendant de la taille de la photo
+        PROXY
+    };
+
+    // Annotation des résultats
+    enum class AnnotationMode {
+        // Cibles et impacts dessinés sur la feuille (annotatedImage)
+        RASTER,
+        // Liste de primitives (overlay), la feuille n'est pas modifiée
+        VECTOR,
+        // Scores uniquement, aucune image retournée
+        NONE
+    };
+
+    // Format d'encodage de l'image annotée
+    enum class ImageEncoding {
+        NONE,
+        JPEG,
+        WEBP,
+        PNG
+    };
+
+    // Encodage de l'image annotée dans le coeur, pour ne transférer que quelques centaines de Ko
+    struct EncodingOptions {
+        ImageEncoding format = ImageEncoding::NONE;
+        // Plus grande dimension de l'image encodée en pixels, 0 conserve la taille de la feuille (côté du profil)
+        int maxDimension = 0;
+        // Qualité JPEG/WEBP (1-100), ignorée en PNG (sans perte)
+        int quality = 90;
+        // Conserver annotatedImage en plus de l'image encodée
+        bool keepImage = false;
+    };
+
+    struct ProcessingOptions {
+        // Pool utilisé pour traiter les zones en parallèle, traitement séquentiel si nul
+        ThreadPool *threadPool = nullptr;
+        SheetDetectionMode sheetDetectionMode = SheetDetectionMode::FULL_RESOLUTION;
+        TargetDetectionMode targetDetectionMode = TargetDetectionMode::FULL_RESOLUTION;
+        // Résolution de la feuille redressée : résultats (cibles, annotation) en coordonnées de cette feuille
+        ResolutionProfile resolution = ResolutionProfile::PRECISE;
+        AnnotationMode annotationMode = AnnotationMode::RASTER;
+        EncodingOptions encoding;
     };
 }
 
@@ -17,7 +17,8 @@ namespace subvision {
     // Rotation d'un point autour d'un centre
     cv::Point2f rotatePoint(const cv::Point2f &center, const cv::Point2f &point, float angle);
 
-    // Obtenir un point sur une ellipse à un angle donné
+    // Obtenir un point sur une ellipse à un angle donné, sans tenir compte de son orientation (convention du
+    // calcul des scores et de la croix des cibles). Ellipse::pointAt tient compte de l'orientation
     cv::Point2f getPointOnEllipse(const Ellipse &ellipse, float angle);
 
     // Agrandir une ellipse par un facteur
@@ -41,9 +42,14 @@ namespace subvision {
     // Obtenir les coordonnées de recadrage pour une zone
     cv::Rect getCropCoordinates(const cv::Mat &image, int targetZone);
 
+    cv::Rect getCropCoordinates(const cv::Size &size, int targetZone);
+
     // Obtenir l'image pour une zone cible
     cv::Mat getTargetPicture(const cv::Mat &sheetMat, int targetZone);
 
+    // Obtenir une vue (sans copie) de la zone cible
+    cv::Mat getTargetView(const cv::Mat &sheetMat, int targetZone);
+
     // Convertir des coordonnées en pourcentage
     std::vector<cv::Point2f> coordinatesToPercentage(const std::vector<cv::Point> &coordinates, int width, int height);
 
@@ -0,0 +1,77 @@
+#ifndef SUBVISION_CORE_VIDEO_SESSION_H
+#define SUBVISION_CORE_VIDEO_SESSION_H
+
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "corner_tracking.h"
+#include "processing_context.h"
+#include "result.h"
+#include "types.h"
+
+namespace subvision {
+    struct VideoSessionOptions {
+        // Options appliquées à la détection des cibles
+        ProcessingOptions processing;
+        // Corrélation minimale (TM_CCOEFF_NORMED) d'un coin pour conserver le suivi
+        float minTrackingScore = 0.8f;
+        // Déplacement maximal d'un coin entre deux images, en pixels de l'image source
+        int searchRadius = 32;
+        // Demi-taille du motif de référence autour de chaque coin, en pixels de l'image source
+        int patchRadius = 16;
+        // Déplacement maximal des coins (pixels source) pour réutiliser les ellipses cibles
+        float targetReuseMaxShift = 3.0f;
+    };
+
+    // Session de traitement d'un flux vidéo : la feuille est détectée une fois puis ses coins
+    // sont suivis d'une image à l'autre, la détection complète n'est relancée qu'en cas de perte du suivi
+    class VideoSession {
+    public:
+        explicit VideoSession(const VideoSessionOptions &options = VideoSessionOptions());
+
+        // Traiter une image BGR du flux, retourne false si aucune feuille ou aucune cible n'est trouvée
+        // (l'erreur est alors dans results.error).
+        // Les buffers sont réutilisés d'une image à l'autre : annotatedImage est réécrite par l'image suivante
+        bool processFrame(const cv::Mat &frame, ImpactResults &results);
+
+        // Oublier la feuille suivie, la prochaine image relance la détection complète
+        void reset();
+
+        // La dernière image a-t-elle été traitée par suivi plutôt que par détection complète
+        bool isTracking() const;
+
+        // Les ellipses cibles de la dernière image proviennent-elles d'une image précédente
+        bool reusedTargets() const;
+
+        // Coins de la feuille dans la dernière image (haut-gauche, haut-droite, bas-droite, bas-gauche)
+        const std::vector<cv::Point2f> &corners() const;
+
+        // Corrélation du coin le moins bien suivi sur la dernière image
+        float trackingScore() const;
+
+    private:
+        bool detectSheet(const cv::Mat &frame);
+
+        bool trackSheet(const cv::Mat &frame);
+
+        Status updateSheetTargets(const SheetAnalysis &analysis);
+
+        VideoSessionOptions options;
+        std::vector<cv::Point2f> sheetCorners;
+        // Motifs de référence des coins, capturés lors de la dernière détection complète
+        CornerPatches patches;
+        double detectedArea = 0;
+        float score = 0;
+        bool tracking = false;
+
+        // Ellipses en coordonnées feuille et coins de l'image sur laquelle elles ont été détectées
+        std::map<int, Ellipse> sheetTargets;
+        std::vector<cv::Point2f> targetCorners;
+        bool targetsReused = false;
+
+        // Buffers de travail réutilisés d'une image à l'autre
+        ProcessingContext context;
+    };
+}
+
+#endif //SUBVISION_CORE_VIDEO_SESSION_H
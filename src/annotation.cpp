@@ -0,0 +1,161 @@
+#include "../include/annotation.h"
+
+#include <algorithm>
+
+#include "../include/constants.h"
+#include "../include/result.h"
+#include "../include/trace.h"
+#include "../include/utils.h"
+
+namespace subvision {
+    OverlayPrimitive makeEllipsePrimitive(const Ellipse &ellipse, const cv::Scalar &color, const int thickness) {
+        OverlayPrimitive primitive;
+        primitive.type = OverlayPrimitiveType::ELLIPSE;
+        primitive.position = ellipse.center();
+        primitive.axes = cv::Size2f(ellipse.halfWidth(), ellipse.halfHeight());
+        primitive.angle = ellipse.angle();
+        primitive.thickness = thickness;
+        primitive.color = color;
+        return primitive;
+    }
+
+    OverlayPrimitive makeLinePrimitive(const cv::Point2f &from, const cv::Point2f &to, const cv::Scalar &color,
+                                       const int thickness) {
+        OverlayPrimitive primitive;
+        primitive.type = OverlayPrimitiveType::LINE;
+        primitive.position = from;
+        primitive.end = to;
+        primitive.thickness = thickness;
+        primitive.color = color;
+        return primitive;
+    }
+
+    OverlayPrimitive makePointPrimitive(const cv::Point2f &center, const float radius, const cv::Scalar &color) {
+        OverlayPrimitive primitive;
+        primitive.type = OverlayPrimitiveType::POINT;
+        primitive.position = center;
+        primitive.size = radius;
+        primitive.thickness = -1;
+        primitive.color = color;
+        return primitive;
+    }
+
+    OverlayPrimitive makeLabelPrimitive(const std::string &text, const cv::Point2f &origin, const float fontScale,
+                                        const cv::Scalar &color, const int thickness) {
+        OverlayPrimitive primitive;
+        primitive.type = OverlayPrimitiveType::LABEL;
+        primitive.position = origin;
+        primitive.size = fontScale;
+        primitive.thickness = thickness;
+        primitive.color = color;
+        primitive.text = text;
+        return primitive;
+    }
+
+    void appendTargetsOverlay(const std::map<int, Ellipse> &targetsEllipsis, std::vector<OverlayPrimitive> &overlay) {
+        constexpr int drawingWidth = 1;
+        const cv::Scalar targetColor(0, 0, 255);
+        constexpr float pi = 3.14159265f;
+        constexpr float halfPi = pi * 0.5f;
+        overlay.reserve(overlay.size() + targetsEllipsis.size() * 7);
+        for (const auto &[_key, ellipseContrat]: targetsEllipsis) {
+            overlay.push_back(makeEllipsePrimitive(ellipseContrat, targetColor, drawingWidth));
+            for (const float factor: TARGET_RING_FACTORS) {
+                overlay.push_back(makeEllipsePrimitive(ellipseContrat.grown(factor), targetColor, drawingWidth));
+            }
+
+            const Ellipse ellipseCrossTip = ellipseContrat.grown(2.2f);
+            const cv::Point2f topPoint = getPointOnEllipse(ellipseCrossTip, halfPi);
+            const cv::Point2f bottomPoint = getPointOnEllipse(ellipseCrossTip, pi + halfPi);
+            const cv::Point2f leftPoint = getPointOnEllipse(ellipseCrossTip, pi);
+            const cv::Point2f rightPoint = getPointOnEllipse(ellipseCrossTip, 0.0f);
+
+            overlay.push_back(makeLinePrimitive(topPoint, bottomPoint, targetColor, drawingWidth));
+            overlay.push_back(makeLinePrimitive(leftPoint, rightPoint, targetColor, drawingWidth));
+        }
+    }
+
+    void drawOverlay(const std::vector<OverlayPrimitive> &overlay, cv::Mat &sheetMat) {
+        SUBVISION_TRACE_SCOPE("drawOverlay");
+        // Les coordonnées sont tronquées comme lors du dessin direct historique
+        for (const auto &primitive: overlay) {
+            switch (primitive.type) {
+                case OverlayPrimitiveType::ELLIPSE:
+                    ellipse(sheetMat, tupleIntCast(primitive.position), primitive.axes, primitive.angle, 0, 360,
+                            primitive.color, primitive.thickness);
+                    break;
+                case OverlayPrimitiveType::LINE:
+                    line(sheetMat, tupleIntCast(primitive.position), tupleIntCast(primitive.end), primitive.color,
+                         primitive.thickness);
+                    break;
+                case OverlayPrimitiveType::POINT:
+                    circle(sheetMat, tupleIntCast(primitive.position), static_cast<int>(primitive.size),
+                           primitive.color, primitive.thickness);
+                    break;
+                case OverlayPrimitiveType::LABEL:
+                    putText(sheetMat, primitive.text, tupleIntCast(primitive.position), cv::FONT_HERSHEY_SIMPLEX,
+                            primitive.size, primitive.color, primitive.thickness);
+                    break;
+            }
+        }
+    }
+
+    std::vector<uchar> encodeImage(const cv::Mat &image, const EncodingOptions &options) {
+        std::vector<uchar> encoded;
+        const Status status = tryEncodeImage(image, options, encoded);
+        if (!status) {
+            raiseError(status.error().message);
+        }
+        return encoded;
+    }
+
+    Status tryEncodeImage(const cv::Mat &image, const EncodingOptions &options, std::vector<uchar> &encoded) {
+        SUBVISION_TRACE_SCOPE("encodeImage");
+        encoded.clear();
+        if (options.format == ImageEncoding::NONE || image.empty()) {
+            return {};
+        }
+
+        cv::Mat scaled = image;
+        const int largest = std::max(image.cols, image.rows);
+        if (options.maxDimension > 0 && largest > options.maxDimension) {
+            const double scale = static_cast<double>(options.maxDimension) / largest;
+            resize(image, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
+        }
+
+#ifdef HAVE_OPENCV_IMGCODECS
+        const int quality = std::clamp(options.quality, 1, 100);
+        std::string extension;
+        std::vector<int> params;
+        switch (options.format) {
+            case ImageEncoding::JPEG:
+                extension = ".jpg";
+                params = {cv::IMWRITE_JPEG_QUALITY, quality};
+                break;
+            case ImageEncoding::WEBP:
+                extension = ".webp";
+                params = {cv::IMWRITE_WEBP_QUALITY, quality};
+                break;
+            case ImageEncoding::PNG:
+                extension = ".png";
+                break;
+            default:
+                return {};
+        }
+
+        if (!cv::imencode(extension, scaled, encoded, params)) {
+            encoded.clear();
+            return Unexpected(ProcessingError{
+                ErrorCode::ENCODING_FAILED, -1, "Unable to encode the annotated image as " + extension
+            });
+        }
+        SUBVISION_LOG_DEBUG("Encoded " << scaled.cols << "x" << scaled.rows << " image as " << extension << ": "
+                            << encoded.size() << " bytes");
+        return {};
+#else
+        return Unexpected(ProcessingError{
+            ErrorCode::ENCODING_FAILED, -1, "Image encoding requires OpenCV imgcodecs"
+        });
+#endif
+    }
+}
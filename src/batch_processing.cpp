@@ -0,0 +1,347 @@
+#include "../include/batch_processing.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/result.h"
+#include "../include/sheet_detection.h"
+#include "../include/target_detection.h"
+#include "../include/trace.h"
+
+namespace subvision {
+    namespace {
+        // File bornée entre deux étapes : push bloque quand la file est pleine
+        template<typename T>
+        class BoundedQueue {
+        public:
+            BoundedQueue(const std::size_t capacity, const std::size_t producerCount)
+                : capacity(std::max<std::size_t>(1, capacity)), remainingProducers(producerCount) {
+            }
+
+            void push(T item) {
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [this] { return items.size() < capacity; });
+                items.push_back(std::move(item));
+                notEmpty.notify_one();
+            }
+
+            // Vide lorsque tous les producteurs ont terminé et que la file est vide
+            std::optional<T> pop() {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [this] { return !items.empty() || remainingProducers == 0; });
+                if (items.empty()) {
+                    return std::nullopt;
+                }
+                T item = std::move(items.front());
+                items.pop_front();
+                notFull.notify_one();
+                return item;
+            }
+
+            void producerDone() {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (remainingProducers > 0 && --remainingProducers == 0) {
+                    notEmpty.notify_all();
+                }
+            }
+
+        private:
+            const std::size_t capacity;
+            std::size_t remainingProducers;
+            std::deque<T> items;
+            std::mutex mutex;
+            std::condition_variable notEmpty;
+            std::condition_variable notFull;
+        };
+
+        // Image en cours de traitement, enrichie par chaque étape
+        struct BatchWork {
+            std::size_t index = 0;
+            cv::Mat image;
+            SheetAnalysis analysis;
+            std::map<int, Ellipse> targetsEllipsis;
+            std::vector<cv::Point2f> impactsCoordinates;
+        };
+
+        // Répartition des workers : la détection des cibles est l'étape la plus coûteuse. Avec moins de 4 workers,
+        // les étapes sont regroupées : un lecteur et des workers qui enchaînent feuille, détection et annotation,
+        // ou tout le batch sur le thread appelant avec un seul worker
+        struct StageWorkers {
+            bool fused = false;
+            std::size_t decode = 1;
+            std::size_t sheet = 1;
+            std::size_t detection = 1;
+            std::size_t annotation = 1;
+        };
+
+        StageWorkers getStageWorkers(const std::size_t workerCount) {
+            StageWorkers workers;
+            if (workerCount < 4) {
+                workers.fused = true;
+                workers.decode = workerCount > 1 ? 1 : 0;
+                workers.sheet = std::max<std::size_t>(1, workerCount - 1);
+                workers.detection = 0;
+                workers.annotation = 0;
+                return workers;
+            }
+            if (workerCount == 4) {
+                return workers;
+            }
+            workers.sheet = std::max<std::size_t>(1, (workerCount - 2) / 3);
+            workers.detection = workerCount - 2 - workers.sheet;
+            return workers;
+        }
+
+        // Limite les threads internes d'OpenCV pendant le batch (BatchOptions::limitOpenCVThreads)
+        class OpenCVThreadsGuard {
+        public:
+            explicit OpenCVThreadsGuard(const int threads) : previousThreads(cv::getNumThreads()) {
+                cv::setNumThreads(threads);
+            }
+
+            ~OpenCVThreadsGuard() {
+                cv::setNumThreads(previousThreads);
+            }
+
+        private:
+            const int previousThreads;
+        };
+
+        // Traitement d'une image par une étape, une erreur est enregistrée dans le résultat de l'image
+        bool processItem(BatchWork &work, std::vector<BatchItemResult> &results,
+                         const std::function<Status(BatchWork &)> &process) {
+            const Status status = catchErrors([&process, &work] { return process(work); });
+            if (!status) {
+                const ProcessingError &error = status.error();
+                SUBVISION_LOG_WARNING("Batch item " << work.index << " failed: " << error.message);
+                results[work.index].error = error.message;
+                results[work.index].results.error = error;
+                return false;
+            }
+            return true;
+        }
+
+        // Boucle d'une étape, la dernière étape n'a pas de file de sortie
+        void runStage(BoundedQueue<BatchWork> &input, BoundedQueue<BatchWork> *output,
+                      std::vector<BatchItemResult> &results, const std::function<Status(BatchWork &)> &process) {
+            while (std::optional<BatchWork> item = input.pop()) {
+                if (processItem(*item, results, process) && output) {
+                    output->push(std::move(*item));
+                }
+            }
+            if (output) {
+                output->producerDone();
+            }
+        }
+
+        std::vector<BatchItemResult> runBatch(const std::size_t count, const BatchOptions &options,
+                                              const std::function<Result<cv::Mat>(std::size_t)> &loadImage,
+                                              std::vector<BatchItemResult> results) {
+            SUBVISION_TRACE_SCOPE("retrieveImpactsBatch");
+            const BatchThreads budget = getBatchThreads(options);
+            const StageWorkers workers = getStageWorkers(budget.workerCount);
+            std::optional<OpenCVThreadsGuard> openCVThreads;
+            if (options.limitOpenCVThreads) {
+                openCVThreads.emplace(budget.openCVThreads);
+            }
+            const ProcessingOptions &processing = options.processing;
+            // Les zones sont détectées sur le worker de l'étape, sans pool
+            ProcessingOptions detection;
+            detection.targetDetectionMode = processing.targetDetectionMode;
+
+            // Détection de la feuille, redressement et masque des impacts. La feuille et le masque passent à l'étape
+            // suivante et sont détachés du contexte après chaque image
+            const auto warpSheet = [&processing](BatchWork &work, ProcessingContext &context) -> Status {
+                const Result<cv::Mat> sheet = tryGetSheetPicture(work.image, context, processing.sheetDetectionMode,
+                                                                 processing.resolution);
+                if (!sheet) {
+                    return Unexpected(sheet.error());
+                }
+                // L'image d'origine est libérée ici, les zones sont tirées de la feuille
+                work.image.release();
+                work.analysis = analyzeSheet(*sheet, context);
+                context.detachResults();
+                return {};
+            };
+
+            // Détection des cibles et des impacts
+            const auto detectTargets = [&detection](BatchWork &work, ProcessingContext &context) -> Status {
+                const Result<std::map<int, Ellipse>> targets = tryGetTargetsEllipse(work.analysis, detection, context);
+                if (!targets) {
+                    return Unexpected(targets.error());
+                }
+                work.targetsEllipsis = targetCoordinatesToSheetCoordinates(*targets, work.analysis.sheet.size());
+                getImpactsCenters(work.analysis.impacts, work.impactsCoordinates);
+                return {};
+            };
+
+            // Annotation et score
+            const auto annotate = [&results, &processing](BatchWork &work) -> Status {
+                BatchItemResult &result = results[work.index];
+                const Status status = tryFillImpactResults(work.analysis, work.targetsEllipsis,
+                                                           work.impactsCoordinates, processing, result.results);
+                result.success = static_cast<bool>(status);
+                return status;
+            };
+
+            // Étapes enchaînées sur le même worker, chaque étape garde ses buffers intermédiaires
+            const auto processAll = [&](BatchWork &work, ProcessingContext &sheetContext,
+                                        ProcessingContext &detectionContext) -> Status {
+                Status status = warpSheet(work, sheetContext);
+                if (status) {
+                    status = detectTargets(work, detectionContext);
+                }
+                if (status) {
+                    status = annotate(work);
+                }
+                return status;
+            };
+
+            // Décodage : un seul lecteur, les images sont distribuées dans l'ordre
+            const auto decodeAll = [&](const std::function<void(BatchWork &&)> &consume) {
+                for (std::size_t index = 0; index < count; ++index) {
+                    BatchWork work;
+                    work.index = index;
+                    const Status status = catchErrors([&loadImage, &work]() -> Status {
+                        Result<cv::Mat> image = loadImage(work.index);
+                        if (!image) {
+                            return Unexpected(image.error());
+                        }
+                        work.image = std::move(*image);
+                        if (work.image.empty()) {
+                            return Unexpected(ProcessingError{ErrorCode::INVALID_IMAGE, -1, "Unable to read image"});
+                        }
+                        return {};
+                    });
+                    if (!status) {
+                        results[index].error = status.error().message;
+                        results[index].results.error = status.error();
+                        continue;
+                    }
+                    consume(std::move(work));
+                }
+            };
+
+            // Un seul worker : tout le batch sur le thread appelant
+            if (workers.decode == 0) {
+                ProcessingContext sheetContext;
+                ProcessingContext detectionContext;
+                decodeAll([&](BatchWork &&work) {
+                    processItem(work, results, [&](BatchWork &item) {
+                        return processAll(item, sheetContext, detectionContext);
+                    });
+                });
+                return results;
+            }
+
+            BoundedQueue<BatchWork> decoded(options.queueCapacity, workers.decode);
+            BoundedQueue<BatchWork> warped(options.queueCapacity, workers.sheet);
+            BoundedQueue<BatchWork> detected(options.queueCapacity, workers.detection);
+
+            std::vector<std::thread> threads;
+
+            threads.emplace_back([&] {
+                decodeAll([&decoded](BatchWork &&work) { decoded.push(std::move(work)); });
+                decoded.producerDone();
+            });
+
+            if (workers.fused) {
+                for (std::size_t i = 0; i < workers.sheet; ++i) {
+                    threads.emplace_back([&] {
+                        ProcessingContext sheetContext;
+                        ProcessingContext detectionContext;
+                        runStage(decoded, nullptr, results, [&](BatchWork &work) {
+                            return processAll(work, sheetContext, detectionContext);
+                        });
+                    });
+                }
+            } else {
+                for (std::size_t i = 0; i < workers.sheet; ++i) {
+                    threads.emplace_back([&] {
+                        ProcessingContext context;
+                        runStage(decoded, &warped, results, [&](BatchWork &work) {
+                            return warpSheet(work, context);
+                        });
+                    });
+                }
+                for (std::size_t i = 0; i < workers.detection; ++i) {
+                    threads.emplace_back([&] {
+                        ProcessingContext context;
+                        runStage(warped, &detected, results, [&](BatchWork &work) {
+                            return detectTargets(work, context);
+                        });
+                    });
+                }
+                for (std::size_t i = 0; i < workers.annotation; ++i) {
+                    threads.emplace_back([&] {
+                        runStage(detected, nullptr, results, annotate);
+                    });
+                }
+            }
+
+            for (auto &thread: threads) {
+                thread.join();
+            }
+
+            return results;
+        }
+    }
+
+    BatchThreads getBatchThreads(const BatchOptions &options) {
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        BatchThreads threads;
+        if (options.limitOpenCVThreads) {
+            // Chaque worker garde les coeurs restants pour cv::parallel_for_
+            threads.workerCount = options.workerCount == 0 ? cores : options.workerCount;
+            threads.openCVThreads = static_cast<int>(std::max<std::size_t>(1, cores / threads.workerCount));
+            return threads;
+        }
+        // Réglage global d'OpenCV conservé : les workers se partagent les coeurs qu'il laisse
+        threads.openCVThreads = std::max(1, cv::getNumThreads());
+        threads.workerCount = options.workerCount != 0
+                                  ? options.workerCount
+                                  : std::max<std::size_t>(1, cores / static_cast<std::size_t>(threads.openCVThreads));
+        return threads;
+    }
+
+    std::vector<BatchItemResult> retrieveImpactsBatch(const std::vector<cv::Mat> &images,
+                                                      const BatchOptions &options) {
+        std::vector<BatchItemResult> results(images.size());
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            results[i].index = i;
+        }
+
+        return runBatch(images.size(), options, [&images](const std::size_t index) -> Result<cv::Mat> {
+            return images[index];
+        },
+                        std::move(results));
+    }
+
+    std::vector<BatchItemResult> retrieveImpactsBatch(const std::vector<std::string> &paths,
+                                                      const BatchOptions &options) {
+        std::vector<BatchItemResult> results(paths.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            results[i].index = i;
+            results[i].source = paths[i];
+        }
+
+        return runBatch(paths.size(), options, [&paths](const std::size_t index) -> Result<cv::Mat> {
+#ifdef HAVE_OPENCV_IMGCODECS
+            return cv::imread(paths[index]);
+#else
+            // Build WebAssembly : OpenCV compilé sans imgcodecs, erreur de l'image sans arrêter le batch
+            (void) paths;
+            (void) index;
+            return Unexpected(ProcessingError{ErrorCode::INVALID_IMAGE, -1,
+                                              "Reading image files requires OpenCV imgcodecs"});
+#endif
+        }, std::move(results));
+    }
+}
@@ -0,0 +1,236 @@
+#include "../include/color_kernels.h"
+
+#include <algorithm>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "../include/trace.h"
+
+namespace subvision {
+    namespace {
+        // Mêmes constantes de point fixe que les conversions 8 bits d'OpenCV
+        constexpr int HSV_SHIFT = 12;
+        constexpr int XYZ_SHIFT = 12;
+        constexpr int Z_RED = 79;
+        constexpr int Z_GREEN = 488;
+        constexpr int Z_BLUE = 3892;
+        constexpr float INV_255 = 1.0f / 255.0f;
+
+        // Table de division de la saturation : (255 << HSV_SHIFT) / v
+        struct SaturationTable {
+            int values[256];
+
+            SaturationTable() {
+                values[0] = 0;
+                for (int i = 1; i < 256; ++i) {
+                    values[i] = cvRound((255 << HSV_SHIFT) / static_cast<double>(i));
+                }
+            }
+        };
+
+        const int *getSaturationTable() {
+            static const SaturationTable table;
+            return table.values;
+        }
+
+        struct SaturationKernel {
+            static constexpr bool ORDER_INDEPENDENT = false;
+            const int *table = getSaturationTable();
+
+            uchar pixel(const int b, const int g, const int r) const {
+                const int vmax = std::max(std::max(b, g), r);
+                const int diff = vmax - std::min(std::min(b, g), r);
+                return static_cast<uchar>((diff * table[vmax] + (1 << (HSV_SHIFT - 1))) >> HSV_SHIFT);
+            }
+
+#if CV_SIMD128
+            cv::v_uint8x16 block(const cv::v_uint8x16 &b, const cv::v_uint8x16 &g, const cv::v_uint8x16 &r) const {
+                const cv::v_uint8x16 vmax = cv::v_max(cv::v_max(b, g), r);
+                const cv::v_uint8x16 diff = vmax - cv::v_min(cv::v_min(b, g), r);
+                const cv::v_int32x4 half = cv::v_setall_s32(1 << (HSV_SHIFT - 1));
+
+                cv::v_uint16x8 max16[2], diff16[2];
+                cv::v_expand(vmax, max16[0], max16[1]);
+                cv::v_expand(diff, diff16[0], diff16[1]);
+
+                cv::v_int16x8 saturation16[2];
+                for (int i = 0; i < 2; ++i) {
+                    cv::v_uint32x4 max32[2], diff32[2];
+                    cv::v_expand(max16[i], max32[0], max32[1]);
+                    cv::v_expand(diff16[i], diff32[0], diff32[1]);
+
+                    cv::v_int32x4 saturation32[2];
+                    for (int j = 0; j < 2; ++j) {
+                        const cv::v_int32x4 divisor = cv::v_lut(table, cv::v_reinterpret_as_s32(max32[j]));
+                        saturation32[j] = (cv::v_reinterpret_as_s32(diff32[j]) * divisor + half) >> HSV_SHIFT;
+                    }
+                    saturation16[i] = cv::v_pack(saturation32[0], saturation32[1]);
+                }
+                return cv::v_pack_u(saturation16[0], saturation16[1]);
+            }
+#endif
+        };
+
+        // cvtColor passe par la conversion flottante pour HLS, les arrondis sont reproduits à l'identique
+        struct LightnessKernel {
+            // max et min ne dépendent pas de l'ordre des canaux : BGR, RGB, BGRA et RGBA sont acceptés
+            static constexpr bool ORDER_INDEPENDENT = true;
+
+            uchar pixel(const int b, const int g, const int r) const {
+                const float vmax = static_cast<float>(std::max(std::max(b, g), r)) * INV_255;
+                const float vmin = static_cast<float>(std::min(std::min(b, g), r)) * INV_255;
+                const float lightness = (vmax + vmin) * 0.5f;
+                return cv::saturate_cast<uchar>(lightness * 255.0f);
+            }
+
+#if CV_SIMD128
+            cv::v_uint8x16 block(const cv::v_uint8x16 &b, const cv::v_uint8x16 &g, const cv::v_uint8x16 &r) const {
+                const cv::v_uint8x16 vmax = cv::v_max(cv::v_max(b, g), r);
+                const cv::v_uint8x16 vmin = cv::v_min(cv::v_min(b, g), r);
+                const cv::v_float32x4 scale = cv::v_setall_f32(INV_255);
+                const cv::v_float32x4 half = cv::v_setall_f32(0.5f);
+                const cv::v_float32x4 full = cv::v_setall_f32(255.0f);
+
+                cv::v_uint16x8 max16[2], min16[2];
+                cv::v_expand(vmax, max16[0], max16[1]);
+                cv::v_expand(vmin, min16[0], min16[1]);
+
+                cv::v_int16x8 lightness16[2];
+                for (int i = 0; i < 2; ++i) {
+                    cv::v_uint32x4 max32[2], min32[2];
+                    cv::v_expand(max16[i], max32[0], max32[1]);
+                    cv::v_expand(min16[i], min32[0], min32[1]);
+
+                    cv::v_int32x4 lightness32[2];
+                    for (int j = 0; j < 2; ++j) {
+                        const cv::v_float32x4 maxF = cv::v_cvt_f32(cv::v_reinterpret_as_s32(max32[j])) * scale;
+                        const cv::v_float32x4 minF = cv::v_cvt_f32(cv::v_reinterpret_as_s32(min32[j])) * scale;
+                        lightness32[j] = cv::v_round(((maxF + minF) * half) * full);
+                    }
+                    lightness16[i] = cv::v_pack(lightness32[0], lightness32[1]);
+                }
+                return cv::v_pack_u(lightness16[0], lightness16[1]);
+            }
+#endif
+        };
+
+        struct InvertedZKernel {
+            static constexpr bool ORDER_INDEPENDENT = false;
+
+            uchar pixel(const int b, const int g, const int r) const {
+                const int z = (r * Z_RED + g * Z_GREEN + b * Z_BLUE + (1 << (XYZ_SHIFT - 1))) >> XYZ_SHIFT;
+                return static_cast<uchar>(255 - std::min(z, 255));
+            }
+
+#if CV_SIMD128
+            cv::v_uint8x16 block(const cv::v_uint8x16 &b, const cv::v_uint8x16 &g, const cv::v_uint8x16 &r) const {
+                const cv::v_int32x4 half = cv::v_setall_s32(1 << (XYZ_SHIFT - 1));
+                const cv::v_int32x4 red = cv::v_setall_s32(Z_RED);
+                const cv::v_int32x4 green = cv::v_setall_s32(Z_GREEN);
+                const cv::v_int32x4 blue = cv::v_setall_s32(Z_BLUE);
+
+                cv::v_uint16x8 b16[2], g16[2], r16[2];
+                cv::v_expand(b, b16[0], b16[1]);
+                cv::v_expand(g, g16[0], g16[1]);
+                cv::v_expand(r, r16[0], r16[1]);
+
+                cv::v_int16x8 z16[2];
+                for (int i = 0; i < 2; ++i) {
+                    cv::v_uint32x4 b32[2], g32[2], r32[2];
+                    cv::v_expand(b16[i], b32[0], b32[1]);
+                    cv::v_expand(g16[i], g32[0], g32[1]);
+                    cv::v_expand(r16[i], r32[0], r32[1]);
+
+                    cv::v_int32x4 z32[2];
+                    for (int j = 0; j < 2; ++j) {
+                        z32[j] = (cv::v_reinterpret_as_s32(r32[j]) * red + cv::v_reinterpret_as_s32(g32[j]) * green +
+                                  cv::v_reinterpret_as_s32(b32[j]) * blue + half) >> XYZ_SHIFT;
+                    }
+                    z16[i] = cv::v_pack(z32[0], z32[1]);
+                }
+                // v_pack_u sature Z à 255 comme cvtColor
+                return cv::v_setall_u8(255) - cv::v_pack_u(z16[0], z16[1]);
+            }
+#endif
+        };
+
+        // Parcours ligne par ligne (les vues non continues sont acceptées), min/max calculés au passage
+        template<typename Kernel>
+        void extractChannel(const cv::Mat &bgr, cv::Mat &dst, double *minVal, double *maxVal, const Kernel &kernel) {
+            const int cn = bgr.channels();
+            CV_Assert(bgr.depth() == CV_8U && (cn == 3 || (cn == 4 && Kernel::ORDER_INDEPENDENT)));
+            dst.create(bgr.size(), CV_8UC1);
+
+            const bool withRange = minVal != nullptr || maxVal != nullptr;
+            uchar lo = 255;
+            uchar hi = 0;
+#if CV_SIMD128
+            constexpr int lanes = cv::v_uint8x16::nlanes;
+            cv::v_uint8x16 vlo = cv::v_setall_u8(255);
+            cv::v_uint8x16 vhi = cv::v_setzero_u8();
+#endif
+
+            for (int y = 0; y < bgr.rows; ++y) {
+                const uchar *src = bgr.ptr<uchar>(y);
+                uchar *out = dst.ptr<uchar>(y);
+                int x = 0;
+#if CV_SIMD128
+                for (; x <= bgr.cols - lanes; x += lanes) {
+                    cv::v_uint8x16 b, g, r, a;
+                    if (cn == 3) {
+                        cv::v_load_deinterleave(src + 3 * x, b, g, r);
+                    } else {
+                        cv::v_load_deinterleave(src + 4 * x, b, g, r, a);
+                    }
+                    const cv::v_uint8x16 value = kernel.block(b, g, r);
+                    cv::v_store(out + x, value);
+                    if (withRange) {
+                        vlo = cv::v_min(vlo, value);
+                        vhi = cv::v_max(vhi, value);
+                    }
+                }
+#endif
+                for (; x < bgr.cols; ++x) {
+                    const uchar value = kernel.pixel(src[cn * x], src[cn * x + 1], src[cn * x + 2]);
+                    out[x] = value;
+                    lo = std::min(lo, value);
+                    hi = std::max(hi, value);
+                }
+            }
+
+            if (!withRange) {
+                return;
+            }
+#if CV_SIMD128
+            uchar los[lanes], his[lanes];
+            cv::v_store(los, vlo);
+            cv::v_store(his, vhi);
+            lo = std::min(lo, *std::min_element(los, los + lanes));
+            hi = std::max(hi, *std::max_element(his, his + lanes));
+#endif
+            if (bgr.empty()) {
+                lo = hi = 0;
+            }
+            if (minVal) {
+                *minVal = lo;
+            }
+            if (maxVal) {
+                *maxVal = hi;
+            }
+        }
+    }
+
+    void extractSaturation(const cv::Mat &bgr, cv::Mat &saturation, double *minVal, double *maxVal) {
+        SUBVISION_TRACE_SCOPE("extractSaturation");
+        extractChannel(bgr, saturation, minVal, maxVal, SaturationKernel());
+    }
+
+    void extractLightness(const cv::Mat &bgr, cv::Mat &lightness, double *minVal, double *maxVal) {
+        SUBVISION_TRACE_SCOPE("extractLightness");
+        extractChannel(bgr, lightness, minVal, maxVal, LightnessKernel());
+    }
+
+    void extractInvertedZ(const cv::Mat &bgr, cv::Mat &invertedZ, double *minVal, double *maxVal) {
+        SUBVISION_TRACE_SCOPE("extractInvertedZ");
+        extractChannel(bgr, invertedZ, minVal, maxVal, InvertedZKernel());
+    }
+}
@@ -0,0 +1,99 @@
+#include "../include/corner_tracking.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../include/trace.h"
+#include "../include/utils.h"
+
+namespace subvision {
+    namespace {
+        // Conversion en niveaux de gris limitée à une fenêtre de l'image
+        cv::Mat getGrayWindow(const cv::Mat &frame, const cv::Rect &window) {
+            cv::Mat gray;
+            cvtColor(frame(window), gray, cv::COLOR_BGR2GRAY);
+            return gray;
+        }
+
+        // Décalage sous-pixel du maximum par interpolation parabolique
+        float getSubPixelOffset(const float previous, const float peak, const float next) {
+            const float denominator = previous - 2.0f * peak + next;
+            if (std::abs(denominator) < 1e-6f) {
+                return 0;
+            }
+            return clamp(0.5f * (previous - next) / denominator, -0.5f, 0.5f);
+        }
+    }
+
+    void CornerPatches::clear() {
+        patches.clear();
+        offsets.clear();
+        radius = 0;
+    }
+
+    void storeCornerPatches(const cv::Mat &frame, const std::vector<cv::Point2f> &corners, const int patchRadius,
+                            CornerPatches &patches) {
+        const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+        const int size = 2 * patchRadius + 1;
+
+        patches.clear();
+        patches.radius = patchRadius;
+        for (const cv::Point2f &corner: corners) {
+            const cv::Point center(cvRound(corner.x), cvRound(corner.y));
+            const cv::Rect patch(center.x - patchRadius, center.y - patchRadius, size, size);
+            // Un coin trop proche du bord de l'image ne peut pas être suivi
+            patches.patches.push_back((patch & bounds) == patch ? getGrayWindow(frame, patch) : cv::Mat());
+            patches.offsets.emplace_back(corner.x - static_cast<float>(center.x),
+                                         corner.y - static_cast<float>(center.y));
+        }
+    }
+
+    float matchCornerPatches(const cv::Mat &frame, const std::vector<cv::Point2f> &corners,
+                             const CornerPatches &patches, const int searchRadius,
+                             std::vector<cv::Point2f> &matched) {
+        SUBVISION_TRACE_SCOPE("matchCornerPatches");
+        const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+        const int windowRadius = searchRadius + patches.radius;
+
+        matched.clear();
+        matched.reserve(corners.size());
+        float minScore = 1.0f;
+
+        for (std::size_t i = 0; i < corners.size(); ++i) {
+            if (i >= patches.patches.size() || patches.patches[i].empty()) {
+                return -1.0f;
+            }
+            const cv::Mat &patch = patches.patches[i];
+
+            const cv::Point previous(cvRound(corners[i].x), cvRound(corners[i].y));
+            const cv::Rect window = cv::Rect(previous.x - windowRadius, previous.y - windowRadius,
+                                             2 * windowRadius + 1, 2 * windowRadius + 1) & bounds;
+            if (window.width <= patch.cols || window.height <= patch.rows) {
+                return -1.0f;
+            }
+
+            cv::Mat correlation;
+            matchTemplate(getGrayWindow(frame, window), patch, correlation, cv::TM_CCOEFF_NORMED);
+
+            double maxValue;
+            cv::Point maxLocation;
+            minMaxLoc(correlation, nullptr, &maxValue, nullptr, &maxLocation);
+            minScore = std::min(minScore, static_cast<float>(maxValue));
+
+            cv::Point2f peak(static_cast<float>(maxLocation.x), static_cast<float>(maxLocation.y));
+            if (maxLocation.x > 0 && maxLocation.x < correlation.cols - 1) {
+                peak.x += getSubPixelOffset(correlation.at<float>(maxLocation.y, maxLocation.x - 1),
+                                            correlation.at<float>(maxLocation.y, maxLocation.x),
+                                            correlation.at<float>(maxLocation.y, maxLocation.x + 1));
+            }
+            if (maxLocation.y > 0 && maxLocation.y < correlation.rows - 1) {
+                peak.y += getSubPixelOffset(correlation.at<float>(maxLocation.y - 1, maxLocation.x),
+                                            correlation.at<float>(maxLocation.y, maxLocation.x),
+                                            correlation.at<float>(maxLocation.y + 1, maxLocation.x));
+            }
+            matched.emplace_back(static_cast<float>(window.x + patches.radius) + peak.x + patches.offsets[i].x,
+                                 static_cast<float>(window.y + patches.radius) + peak.y + patches.offsets[i].y);
+        }
+        return minScore;
+    }
+}
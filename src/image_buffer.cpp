@@ -0,0 +1,216 @@
+#include "../include/image_buffer.h"
+
+#include "../include/result.h"
+#include "../include/trace.h"
+
+namespace subvision {
+    namespace {
+        int getPlaneCount(const PixelFormat format) {
+            switch (format) {
+                case PixelFormat::NV12:
+                case PixelFormat::NV21:
+                    return 2;
+                case PixelFormat::I420:
+                    return 3;
+                default:
+                    return 1;
+            }
+        }
+
+        // Pas minimal d'un plan : une ligne complète de pixels
+        size_t getMinimumStride(const PixelFormat format, const int width, const int plane) {
+            const size_t columns = static_cast<size_t>(width);
+            switch (format) {
+                case PixelFormat::RGBA:
+                    return columns * 4;
+                case PixelFormat::BGR:
+                    return columns * 3;
+                case PixelFormat::I420:
+                    return plane == 0 ? columns : columns / 2;
+                default:
+                    // NV12 / NV21 : plan Y, puis plan UV entrelacé de width / 2 couples
+                    return columns;
+            }
+        }
+
+        Result<ImageBuffer> invalidImage(const char *message) {
+            return Unexpected(ProcessingError{ErrorCode::INVALID_IMAGE, -1, message});
+        }
+
+        // Image décrite puis vérifiée, sans exception
+        Result<ImageBuffer> checkedImageBuffer(const ImageBuffer &image) {
+            const Status status = validateImageBuffer(image);
+            if (!status) {
+                return Unexpected(status.error());
+            }
+            return image;
+        }
+
+        Result<ImageBuffer> tryMakeSemiPlanarImageBuffer(const PixelFormat format, const int width, const int height,
+                                                         const uchar *y, const size_t yStride, const uchar *uv,
+                                                         const size_t uvStride) {
+            if (format != PixelFormat::NV12 && format != PixelFormat::NV21) {
+                return invalidImage("Semi-planar images must be NV12 or NV21");
+            }
+            ImageBuffer image;
+            image.format = format;
+            image.width = width;
+            image.height = height;
+            image.planes[0] = y;
+            image.planes[1] = uv;
+            image.strides[0] = yStride != 0 ? yStride : static_cast<size_t>(width);
+            image.strides[1] = uvStride != 0 ? uvStride : static_cast<size_t>(width);
+            return checkedImageBuffer(image);
+        }
+
+        Result<ImageBuffer> tryMakePlanarImageBuffer(const int width, const int height, const uchar *y,
+                                                     const size_t yStride, const uchar *u, const size_t uStride,
+                                                     const uchar *v, const size_t vStride) {
+            ImageBuffer image;
+            image.format = PixelFormat::I420;
+            image.width = width;
+            image.height = height;
+            image.planes[0] = y;
+            image.planes[1] = u;
+            image.planes[2] = v;
+            image.strides[0] = yStride != 0 ? yStride : static_cast<size_t>(width);
+            image.strides[1] = uStride != 0 ? uStride : static_cast<size_t>(width / 2);
+            image.strides[2] = vStride != 0 ? vStride : static_cast<size_t>(width / 2);
+            return checkedImageBuffer(image);
+        }
+    }
+
+    Result<ImageBuffer> tryMakePackedImageBuffer(const PixelFormat format, const int width, const int height,
+                                                 const uchar *data, const size_t stride) {
+        if (format != PixelFormat::BGR && format != PixelFormat::RGBA) {
+            return invalidImage("Packed images must be BGR or RGBA");
+        }
+        ImageBuffer image;
+        image.format = format;
+        image.width = width;
+        image.height = height;
+        image.planes[0] = data;
+        image.strides[0] = stride != 0 ? stride : static_cast<size_t>(width) * (format == PixelFormat::RGBA ? 4 : 3);
+        return checkedImageBuffer(image);
+    }
+
+    Result<ImageBuffer> tryMakeContiguousYuvImageBuffer(const PixelFormat format, const int width, const int height,
+                                                        const uchar *data) {
+        if (!isYuvFormat(format)) {
+            return invalidImage("Contiguous YUV images must be NV12, NV21 or I420");
+        }
+        if (width <= 0 || height <= 0) {
+            return invalidImage("Invalid image size");
+        }
+        const size_t lumaSize = static_cast<size_t>(width) * height;
+        if (format == PixelFormat::I420) {
+            return tryMakePlanarImageBuffer(width, height, data, 0, data + lumaSize, 0,
+                                            data + lumaSize + lumaSize / 4, 0);
+        }
+        return tryMakeSemiPlanarImageBuffer(format, width, height, data, 0, data + lumaSize, 0);
+    }
+
+    ImageBuffer makePackedImageBuffer(const PixelFormat format, const int width, const int height, const uchar *data,
+                                      const size_t stride) {
+        return valueOrRaise(tryMakePackedImageBuffer(format, width, height, data, stride));
+    }
+
+    ImageBuffer makeSemiPlanarImageBuffer(const PixelFormat format, const int width, const int height,
+                                          const uchar *y, const size_t yStride, const uchar *uv,
+                                          const size_t uvStride) {
+        return valueOrRaise(tryMakeSemiPlanarImageBuffer(format, width, height, y, yStride, uv, uvStride));
+    }
+
+    ImageBuffer makePlanarImageBuffer(const int width, const int height, const uchar *y, const size_t yStride,
+                                      const uchar *u, const size_t uStride, const uchar *v, const size_t vStride) {
+        return valueOrRaise(tryMakePlanarImageBuffer(width, height, y, yStride, u, uStride, v, vStride));
+    }
+
+    ImageBuffer makeContiguousYuvImageBuffer(const PixelFormat format, const int width, const int height,
+                                             const uchar *data) {
+        return valueOrRaise(tryMakeContiguousYuvImageBuffer(format, width, height, data));
+    }
+
+    Status validateImageBuffer(const ImageBuffer &image) {
+        const auto invalid = [](const char *message) {
+            return Unexpected(ProcessingError{ErrorCode::INVALID_IMAGE, -1, message});
+        };
+        if (image.width <= 0 || image.height <= 0) {
+            return invalid("Invalid image size");
+        }
+        if (isYuvFormat(image.format) && (image.width % 2 != 0 || image.height % 2 != 0)) {
+            return invalid("YUV 4:2:0 images must have even dimensions");
+        }
+        for (int plane = 0; plane < getPlaneCount(image.format); ++plane) {
+            if (image.planes[plane] == nullptr) {
+                return invalid("Missing image plane");
+            }
+            if (image.strides[plane] < getMinimumStride(image.format, image.width, plane)) {
+                return invalid("Image stride is smaller than the row size");
+            }
+        }
+        return {};
+    }
+
+    bool isYuvFormat(const PixelFormat format) {
+        return format == PixelFormat::NV12 || format == PixelFormat::NV21 || format == PixelFormat::I420;
+    }
+
+    cv::Mat getPlaneView(const ImageBuffer &image, const int plane) {
+        if (plane < 0 || plane >= getPlaneCount(image.format)) {
+            raiseError("Invalid image plane");
+        }
+        // cv::Mat n'a pas de vue en lecture seule, les plans ne sont jamais modifiés
+        auto *data = const_cast<uchar *>(image.planes[plane]);
+        const size_t step = image.strides[plane];
+
+        switch (image.format) {
+            case PixelFormat::BGR:
+                return cv::Mat(image.height, image.width, CV_8UC3, data, step);
+            case PixelFormat::RGBA:
+                return cv::Mat(image.height, image.width, CV_8UC4, data, step);
+            case PixelFormat::NV12:
+            case PixelFormat::NV21:
+                if (plane == 1) {
+                    return cv::Mat(image.height / 2, image.width / 2, CV_8UC2, data, step);
+                }
+                return cv::Mat(image.height, image.width, CV_8UC1, data, step);
+            case PixelFormat::I420:
+                if (plane > 0) {
+                    return cv::Mat(image.height / 2, image.width / 2, CV_8UC1, data, step);
+                }
+                return cv::Mat(image.height, image.width, CV_8UC1, data, step);
+        }
+        raiseError("Unsupported pixel format");
+    }
+
+    cv::Mat toBgr(const ImageBuffer &image) {
+        SUBVISION_TRACE_SCOPE("toBgr");
+        cv::Mat bgr;
+        switch (image.format) {
+            case PixelFormat::BGR:
+                return getPlaneView(image, 0).clone();
+            case PixelFormat::RGBA:
+                cvtColor(getPlaneView(image, 0), bgr, cv::COLOR_RGBA2BGR);
+                return bgr;
+            case PixelFormat::NV12:
+            case PixelFormat::NV21:
+                cvtColorTwoPlane(getPlaneView(image, 0), getPlaneView(image, 1), bgr,
+                                 image.format == PixelFormat::NV12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_NV21);
+                return bgr;
+            case PixelFormat::I420: {
+                // cvtColor attend les trois plans dans un seul buffer contigu
+                cv::Mat yuv(image.height * 3 / 2, image.width, CV_8UC1);
+                const size_t lumaSize = static_cast<size_t>(image.width) * image.height;
+                cv::Mat u(image.height / 2, image.width / 2, CV_8UC1, yuv.data + lumaSize);
+                cv::Mat v(image.height / 2, image.width / 2, CV_8UC1, yuv.data + lumaSize + lumaSize / 4);
+                getPlaneView(image, 0).copyTo(yuv.rowRange(0, image.height));
+                getPlaneView(image, 1).copyTo(u);
+                getPlaneView(image, 2).copyTo(v);
+                cvtColor(yuv, bgr, cv::COLOR_YUV2BGR_I420);
+                return bgr;
+            }
+        }
+        raiseError("Unsupported pixel format");
+    }
+}
@@ -1,27 +1,86 @@
 #include "../include/image_processing.h"
+
+#include <cstdint>
+
+#include "../include/color_kernels.h"
 #include "../include/constants.h"
+#include "../include/morphology.h"
+#include "../include/trace.h"
 #include "../include/utils.h"
 
 namespace subvision {
+    namespace {
+        // Ellipse de mêmes moments d'ordre 2 que la composante, parcourue dans sa boîte englobante.
+        // Pour une ellipse pleine, la variance le long d'un axe vaut (demi-axe / 2)², d'où axe = 4 * sqrt(λ)
+        ImpactBlob getImpactBlob(const cv::Mat &labels, const int label, const cv::Rect &box, const int area) {
+            // Coordonnées relatives au coin de la boîte : sommes entières exactes
+            int64_t sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+            for (int y = 0; y < box.height; ++y) {
+                const int *row = labels.ptr<int>(box.y + y) + box.x;
+                for (int x = 0; x < box.width; ++x) {
+                    if (row[x] == label) {
+                        sx += x;
+                        sy += y;
+                        sxx += x * x;
+                        sxy += x * y;
+                        syy += y * y;
+                    }
+                }
+            }
+
+            const double n = area;
+            const double cx = static_cast<double>(sx) / n;
+            const double cy = static_cast<double>(sy) / n;
+            const double mu20 = static_cast<double>(sxx) / n - cx * cx;
+            const double mu11 = static_cast<double>(sxy) / n - cx * cy;
+            const double mu02 = static_cast<double>(syy) / n - cy * cy;
+
+            const double mean = (mu20 + mu02) * 0.5;
+            const double delta = std::sqrt((mu20 - mu02) * (mu20 - mu02) * 0.25 + mu11 * mu11);
+
+            ImpactBlob blob;
+            blob.center = cv::Point2f(static_cast<float>(box.x + cx), static_cast<float>(box.y + cy));
+            blob.axes = cv::Size2f(static_cast<float>(4.0 * std::sqrt(mean + delta)),
+                                   static_cast<float>(4.0 * std::sqrt(std::max(mean - delta, 0.0))));
+            blob.angle = static_cast<float>(0.5 * std::atan2(2.0 * mu11, mu20 - mu02) * 180.0 / CV_PI);
+            blob.area = area;
+            return blob;
+        }
+    }
+
     std::vector<cv::Point> getBiggestValidContour(const std::vector<std::vector<cv::Point> > &contours) {
-        std::cout << "Start processing getBiggestValidContour with " << contours.size() << " contours" << std::endl;
+        return getBiggestValidContour(contours, cv::Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION));
+    }
+
+    std::vector<cv::Point> getBiggestValidContour(const std::vector<std::vector<cv::Point> > &contours,
+                                                  const cv::Size &imageSize) {
+        SUBVISION_TRACE_SCOPE("getBiggestValidContour");
         std::vector<cv::Point> biggestContour;
         double biggestArea = 0;
-        constexpr double totalArea = PICTURE_WIDTH_SHEET_DETECTION * PICTURE_HEIGHT_SHEET_DETECTION;
+        const double totalArea = static_cast<double>(imageSize.area());
         constexpr double minAreaRatio = 0.1;
         constexpr double maxAreaRatio = 0.9;
         constexpr float minAngle = 70.0f;
         constexpr float maxAngle = 110.0f;
         constexpr float invPI180 = 180.0f / static_cast<float>(CV_PI);
+        const double minArea = minAreaRatio * totalArea;
 
         std::vector<cv::Point> approx;
         approx.reserve(4);
 
         for (const auto &contour: contours) {
-            std::cout <<  "Processing contour with size: " << contour.size() << std::endl;
             if (contour.size() < 4)
                 continue;
 
+            // Le polygone approché a ses sommets sur le contour : son aire est bornée par la boîte englobante.
+            // Les contours trop petits (bruit, trous) sont écartés avant approxPolyDP
+            const double boxArea = static_cast<double>(cv::boundingRect(contour).area());
+            if (boxArea < minArea || boxArea <= biggestArea)
+                continue;
+            // Marge d'un facteur 2 entre l'aire du contour et celle du polygone approché
+            if (cv::contourArea(contour) < 0.5 * minArea)
+                continue;
+
             const double epsilon = 0.01 * cv::arcLength(contour, true);
             approx.clear();
             cv::approxPolyDP(contour, approx, epsilon, true);
@@ -74,79 +133,122 @@ namespace subvision {
             biggestArea = area;
         }
 
-        std::cout << "Biggest contour found with size: " << biggestContour.size() << std::endl;
+        SUBVISION_LOG_DEBUG("Biggest valid contour among " << contours.size() << " contours has "
+            << biggestContour.size() << " points");
 
         return biggestContour;
     }
 
     cv::Mat getImpactsMask(const cv::Mat &image) {
-        const auto start = std::chrono::high_resolution_clock::now();
-        cv::Mat hsv, mask;
-        cvtColor(image, hsv, cv::COLOR_BGR2HSV);
+        ProcessingContext context;
+        return getImpactsMask(image, context);
+    }
 
-        std::vector<cv::Mat> channels(3);
-        split(hsv, channels);
-        const cv::Mat &saturation = channels[1];
+    cv::Mat getImpactsMask(const cv::Mat &image, ProcessingContext &context) {
+        return getImpactsMask(image, context, PRECISE_PROFILE);
+    }
 
+    cv::Mat getImpactsMask(const cv::Mat &image, ProcessingContext &context, const ProcessingProfile &profile) {
+        SUBVISION_TRACE_SCOPE("getImpactsMask");
+        cv::Mat &saturation = context.saturation;
+        cv::Mat &mask = context.impactsScratch;
         double minVal, maxVal;
-        cv::minMaxLoc(saturation, &minVal, &maxVal);
+        extractSaturation(image, saturation, &minVal, &maxVal);
 
         maxVal = std::max(maxVal, 120.0);
         minVal = (maxVal - minVal) * 0.5 + minVal;
 
         cv::inRange(saturation, cv::Scalar(minVal), cv::Scalar(maxVal), mask);
 
-        cv::Mat element;
-        cv::erode(mask, mask, element, cv::Point(-1, -1), 2);
-        cv::dilate(mask, mask, element, cv::Point(-1, -1), 2);
+        erodeRect(mask, mask, profile.impactMorphologyRadius, context.morphology);
+        dilateRect(mask, mask, profile.impactMorphologyRadius, context.morphology);
 
-        threshold(mask, mask, 127, 255, cv::THRESH_BINARY);
-
-        std::vector<std::vector<cv::Point> > contours;
-        cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        extractImpacts(mask, context.impacts, context, &context.impactsMask);
+        return context.impactsMask;
+    }
 
-        cv::Mat result = cv::Mat::zeros(mask.size(), mask.type());
-        std::vector<cv::Point> ellipsePoints;
-        ellipsePoints.reserve(90);
+    void extractImpacts(const cv::Mat &mask, std::vector<ImpactBlob> &impacts, ProcessingContext &context,
+                        cv::Mat *ellipseMask) {
+        SUBVISION_TRACE_SCOPE("extractImpacts");
+        cv::Mat &labels = context.impactLabels;
+        cv::Mat &stats = context.impactStats;
+        const int count = cv::connectedComponentsWithStats(mask, labels, stats, context.impactCentroids, 8, CV_32S);
+
+        impacts.clear();
+        if (ellipseMask) {
+            ellipseMask->create(mask.size(), CV_8UC1);
+            ellipseMask->setTo(cv::Scalar(0));
+        }
+        std::vector<cv::Point> &ellipsePoints = context.ellipsePoints;
+
+        // Composante 0 : le fond
+        for (int label = 1; label < count; ++label) {
+            const int *stat = stats.ptr<int>(label);
+            const cv::Rect box(stat[cv::CC_STAT_LEFT], stat[cv::CC_STAT_TOP], stat[cv::CC_STAT_WIDTH],
+                               stat[cv::CC_STAT_HEIGHT]);
+            const int area = stat[cv::CC_STAT_AREA];
+            // Rectangle plein (pixel isolé, trait) : pas d'ellipse, comme un contour de moins de 5 points
+            if (area == box.area()) {
+                continue;
+            }
 
-        for (const auto &contour: contours) {
-            if (contour.size() >= 5) {
-                const cv::RotatedRect ellipse = cv::fitEllipse(contour);
+            impacts.push_back(getImpactBlob(labels, label, box, area));
+            if (ellipseMask) {
+                const ImpactBlob &impact = impacts.back();
                 ellipsePoints.clear();
-                cv::ellipse2Poly(ellipse.center, cv::Size2f(ellipse.size.width * 0.5f, ellipse.size.height * 0.5f),
-                                 static_cast<int>(ellipse.angle), 0, 360, 4, ellipsePoints);
-                cv::fillConvexPoly(result, ellipsePoints, cv::Scalar(255));
+                cv::ellipse2Poly(impact.center, cv::Size2f(impact.axes.width * 0.5f, impact.axes.height * 0.5f),
+                                 static_cast<int>(impact.angle), 0, 360, 4, ellipsePoints);
+                cv::fillConvexPoly(*ellipseMask, ellipsePoints, cv::Scalar(255));
             }
         }
+    }
+
+    std::vector<ImpactBlob> extractImpacts(const cv::Mat &mask, cv::Mat *ellipseMask) {
+        ProcessingContext context;
+        std::vector<ImpactBlob> impacts;
+        extractImpacts(mask, impacts, context, ellipseMask);
+        return impacts;
+    }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour getImpactsMask: " << elapsed.count() << " secondes" << std::endl;
-        return result;
+    void getImpactsCenters(const std::vector<ImpactBlob> &impacts, std::vector<cv::Point2f> &centers) {
+        centers.clear();
+        centers.reserve(impacts.size());
+        for (const auto &impact: impacts) {
+            centers.push_back(impact.center);
+        }
     }
 
     std::vector<cv::Point2f> getImpactsCoordinates(const cv::Mat &image) {
-        const auto start = std::chrono::high_resolution_clock::now();
-        const cv::Mat mask = getImpactsMask(image);
+        ProcessingContext context;
+        getImpactsMask(image, context);
+        getImpactsCenters(context.impacts, context.impactsCoordinates);
+        return context.impactsCoordinates;
+    }
 
-        std::vector<std::vector<cv::Point> > contours;
-        findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    std::vector<cv::Point2f> getImpactsCoordinatesFromMask(const cv::Mat &mask) {
+        ProcessingContext context;
+        return getImpactsCoordinatesFromMask(mask, context);
+    }
 
-        std::vector<cv::Point2f> centers;
-        centers.reserve(contours.size());
+    const std::vector<cv::Point2f> &getImpactsCoordinatesFromMask(const cv::Mat &mask, ProcessingContext &context) {
+        SUBVISION_TRACE_SCOPE("getImpactsCoordinates");
+        extractImpacts(mask, context.impacts, context);
+        getImpactsCenters(context.impacts, context.impactsCoordinates);
+        return context.impactsCoordinates;
+    }
 
-        for (const auto &contour: contours) {
-            if (contour.size() >= 5) {
-                const cv::RotatedRect ellipse = fitEllipse(contour);
-                if (!isnan(ellipse.center.x) && !isnan(ellipse.center.y)) {
-                    centers.push_back(ellipse.center);
-                }
-            }
-        }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour getImpactsCoordinates: " << elapsed.count() << " secondes" << std::endl;
-        return centers;
+    SheetAnalysis analyzeSheet(const cv::Mat &sheetMat) {
+        ProcessingContext context;
+        return analyzeSheet(sheetMat, context);
+    }
+
+    SheetAnalysis analyzeSheet(const cv::Mat &sheetMat, ProcessingContext &context) {
+        SUBVISION_TRACE_SCOPE("analyzeSheet");
+        SheetAnalysis analysis;
+        analysis.sheet = sheetMat;
+        analysis.impactsMask = getImpactsMask(sheetMat, context, getProcessingProfile(sheetMat.cols));
+        analysis.impacts.swap(context.impacts);
+        return analysis;
     }
 
     cv::Mat getColorMask(const cv::Mat &mat, const cv::Scalar &color) {
@@ -163,21 +265,24 @@ namespace subvision {
         cv::Mat mask;
         inRange(hsvMat, minVal, maxVal, mask);
 
-        cv::Mat kernel = getStructuringElement(
-            cv::MORPH_RECT, cv::Size(PICTURE_WIDTH_SHEET_DETECTION / 200, PICTURE_HEIGHT_SHEET_DETECTION / 200));
-        cv::erode(mask, mask, cv::Mat(), cv::Point(-1, -1), 2);
-        cv::dilate(mask, mask, cv::Mat(), cv::Point(-1, -1), 2);
+        MorphologyBuffers buffers;
+        erodeRect(mask, mask, 2, buffers);
+        dilateRect(mask, mask, 2, buffers);
         threshold(mask, mask, 127, 255, cv::THRESH_BINARY);
 
         return mask;
     }
 
     Ellipse retrieveEllipse(const cv::Mat &image) {
-        const auto start = std::chrono::high_resolution_clock::now();
         std::vector<std::vector<cv::Point> > contours;
+        return retrieveEllipse(image, contours);
+    }
+
+    Ellipse retrieveEllipse(const cv::Mat &image, std::vector<std::vector<cv::Point> > &contours) {
+        SUBVISION_TRACE_SCOPE("retrieveEllipse");
         findContours(image, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
-        Ellipse emptyEllipse = std::make_tuple(cv::Point2f(0, 0), cv::Size2f(0, 0), 0.0f);
+        const Ellipse emptyEllipse;
 
         if (contours.empty()) {
             return emptyEllipse;
@@ -191,11 +296,7 @@ namespace subvision {
         const std::vector<cv::Point> &biggestContour = *maxIt;
 
         if (biggestContour.size() >= 5) {
-            const cv::RotatedRect rotatedRect = fitEllipse(biggestContour);
-            const auto end = std::chrono::high_resolution_clock::now();
-            const std::chrono::duration<double> elapsed = end - start;
-            std::cout << "Temps écoulé pour retrieveEllipse: " << elapsed.count() << " secondes" << std::endl;
-            return std::make_tuple(rotatedRect.center, rotatedRect.size, rotatedRect.angle);
+            return Ellipse(fitEllipse(biggestContour));
         }
 
         cv::Mat mask = cv::Mat::zeros(image.size(), CV_8UC1);
@@ -205,16 +306,9 @@ namespace subvision {
         findNonZero(mask, ptsEdges);
 
         if (ptsEdges.size() >= 5) {
-            const cv::RotatedRect rotatedRect = fitEllipse(ptsEdges);
-            const auto end = std::chrono::high_resolution_clock::now();
-            const std::chrono::duration<double> elapsed = end - start;
-            std::cout << "Temps écoulé pour retrieveEllipse: " << elapsed.count() << " secondes" << std::endl;
-            return std::make_tuple(rotatedRect.center, rotatedRect.size, rotatedRect.angle);
+            return Ellipse(fitEllipse(ptsEdges));
         }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour retrieveEllipse: " << elapsed.count() << " secondes" << std::endl;
         return emptyEllipse;
     }
 }
@@ -1,24 +1,97 @@
 #include "../include/impact_detection.h"
 
 #include "sheet_detection.h"
+#include "../include/annotation.h"
 #include "../include/constants.h"
+#include "../include/image_buffer.h"
 #include "../include/utils.h"
 #include "../include/image_processing.h"
+#include "../include/result.h"
+#include "../include/scoring.h"
 #include "../include/target_detection.h"
+#include "../include/thread_pool.h"
+#include "../include/trace.h"
 
 namespace subvision {
+    namespace {
+        // Taille d'annotation mise à l'échelle de la feuille, au moins 1
+        int scaleAnnotation(const int value, const float scale) {
+            return std::max(1, static_cast<int>(std::lround(static_cast<float>(value) * scale)));
+        }
 
-    std::vector<Impact> drawAndGetImpactsPoints(const std::vector<cv::Point2f> &impacts, cv::Mat &sheetMat,
-                                              const std::map<int, Ellipse> &targetsEllipsis) {
-        const auto start = std::chrono::high_resolution_clock::now();
+        // Traitement commun à partir de la feuille redressée (côté du profil de résolution), tous les
+        // intermédiaires dans le contexte. source est l'image d'origine en BGR, vide si les zones doivent être tirées de la feuille
+        Status retrieveImpactsFromSheetPicture(const cv::Mat &sheetMat, const cv::Mat &source, ImpactResults &results,
+                                               const ProcessingOptions &options, ProcessingContext &context) {
+            // Impacts mask is computed once and shared by every stage
+            SheetAnalysis analysis = analyzeSheet(sheetMat, context);
+            if (!source.empty()) {
+                analysis.source = source;
+                analysis.transform = context.sheetTransform;
+            }
+
+            // Impacts déjà extraits avec le masque, rendus au contexte pour réutiliser leur capacité
+            getImpactsCenters(analysis.impacts, context.impactsCoordinates);
+            context.impacts.swap(analysis.impacts);
+
+            // Get targets ellipses
+            const Status targets = tryGetTargetsEllipse(analysis, options, context, context.targetsEllipsis);
+            if (!targets) {
+                return targets;
+            }
+            targetCoordinatesToSheetCoordinates(context.targetsEllipsis, sheetMat.size(),
+                                                context.sheetTargetsEllipsis);
+
+            SUBVISION_TRACE_SCOPE("retrieveImpactsFromSheet");
+            return tryFillImpactResults(analysis, context.sheetTargetsEllipsis, context.impactsCoordinates, options,
+                                        results);
+        }
+
+        // Copier les ellipses en réutilisant les nœuds déjà présents : l'affectation de std::map réalloue
+        // tous ses nœuds avec certaines bibliothèques standard
+        void assignEllipses(const std::map<int, Ellipse> &source, std::map<int, Ellipse> &destination) {
+            for (auto it = destination.begin(); it != destination.end();) {
+                it = source.count(it->first) > 0 ? std::next(it) : destination.erase(it);
+            }
+            for (const auto &[zone, ellipse]: source) {
+                destination[zone] = ellipse;
+            }
+        }
+
+        // Erreur recopiée dans les résultats pour les appelants qui ne conservent que ImpactResults
+        Status recordError(Status status, ImpactResults &results) {
+            results.error = status ? ProcessingError() : status.error();
+            return status;
+        }
+    }
+
+    std::vector<Impact> scoreImpacts(const std::vector<cv::Point2f> &impacts,
+                                     const std::map<int, Ellipse> &targetsEllipsis,
+                                     std::vector<OverlayPrimitive> *overlay, const float scale) {
         std::vector<Impact> points;
+        scoreImpacts(impacts, targetsEllipsis, points, overlay, scale);
+        return points;
+    }
+
+    void scoreImpacts(const std::vector<cv::Point2f> &impacts, const std::map<int, Ellipse> &targetsEllipsis,
+                      std::vector<Impact> &points, std::vector<OverlayPrimitive> *overlay, const float scale) {
+        SUBVISION_TRACE_SCOPE("scoreImpacts");
+        points.clear();
         points.reserve(impacts.size());
+        if (overlay) {
+            overlay->reserve(overlay->size() + impacts.size() * 7);
+        }
 
         const cv::Scalar blue(255, 0, 0);
         const cv::Scalar black(0, 0, 0);
         const cv::Scalar orange(0, 165, 255);
         const cv::Scalar white(255, 255, 255);
-        constexpr int perpendicularLineLength = 25;
+        const float perpendicularLineLength = static_cast<float>(scaleAnnotation(25, scale));
+        const int lineThickness = scaleAnnotation(2, scale);
+        const float pointRadius = static_cast<float>(scaleAnnotation(5, scale));
+        const float fontScale = 2.0f * scale;
+        const int outlineThickness = scaleAnnotation(20, scale);
+        const int labelThickness = scaleAnnotation(10, scale);
         constexpr float pi = 3.14159265f;
 
         for (const auto &impact: impacts) {
@@ -26,7 +99,7 @@ namespace subvision {
             float minDistanceSq = std::numeric_limits<float>::max();
 
             for (const auto &[zone, ellipse]: targetsEllipsis) {
-                const cv::Point2f &ellipseCenter = std::get<0>(ellipse);
+                const cv::Point2f &ellipseCenter = ellipse.center();
                 const float dx = impact.x - ellipseCenter.x;
                 const float dy = impact.y - ellipseCenter.y;
                 const float distanceSq = dx * dx + dy * dy;
@@ -37,70 +110,182 @@ namespace subvision {
                 }
             }
 
-            const Ellipse targetEllipsis = growEllipse(targetsEllipsis.at(closestZone), 1.8f);
-            const cv::Point center = tupleIntCast(std::get<0>(targetEllipsis));
+            const Ellipse targetEllipsis = targetsEllipsis.at(closestZone).grown(TARGET_SCORING_GROWTH);
+            const cv::Point center = tupleIntCast(targetEllipsis.center());
             const float radAngle = getAngle(impact, center) + pi;
             const cv::Point2f pointOnEllipse = getPointOnEllipse(targetEllipsis, radAngle);
-            const cv::Point pointOnEllipseInt = tupleIntCast(pointOnEllipse);
-            const cv::Point impactInt = tupleIntCast(impact);
 
-            line(sheetMat, center, pointOnEllipseInt, black, 2);
-            circle(sheetMat, center, 5, blue, -1);
-            circle(sheetMat, pointOnEllipseInt, 5, blue, -1);
-            circle(sheetMat, impactInt, 5, orange, -1);
+            const int realDistance = getRealDistance(center, pointOnEllipse, impact);
+            const int score = getScore(realDistance);
 
-            const float dx = pointOnEllipse.x - center.x;
-            const float dy = pointOnEllipse.y - center.y;
-            const float invNorm = 1.0f / std::sqrt(dx * dx + dy * dy);
-            const float perpDx = -dy * invNorm * perpendicularLineLength;
-            const float perpDy = dx * invNorm * perpendicularLineLength;
+            if (overlay) {
+                const cv::Point2f pointOnEllipseInt = tupleIntCast(pointOnEllipse);
+                const cv::Point2f impactInt = tupleIntCast(impact);
 
-            const cv::Point perpPoint1(static_cast<int>(impact.x + perpDx), static_cast<int>(impact.y + perpDy));
-            const cv::Point perpPoint2(static_cast<int>(impact.x - perpDx), static_cast<int>(impact.y - perpDy));
-            line(sheetMat, perpPoint1, perpPoint2, orange, 2);
+                overlay->push_back(makeLinePrimitive(center, pointOnEllipseInt, black, lineThickness));
+                overlay->push_back(makePointPrimitive(center, pointRadius, blue));
+                overlay->push_back(makePointPrimitive(pointOnEllipseInt, pointRadius, blue));
+                overlay->push_back(makePointPrimitive(impactInt, pointRadius, orange));
 
-            const int realDistance = getRealDistance(center, pointOnEllipse, impact);
-            const int score = getScore(realDistance);
+                const float dx = pointOnEllipse.x - center.x;
+                const float dy = pointOnEllipse.y - center.y;
+                const float invNorm = 1.0f / std::sqrt(dx * dx + dy * dy);
+                const float perpDx = -dy * invNorm * perpendicularLineLength;
+                const float perpDy = dx * invNorm * perpendicularLineLength;
+
+                const cv::Point2f perpPoint1(impact.x + perpDx, impact.y + perpDy);
+                const cv::Point2f perpPoint2(impact.x - perpDx, impact.y - perpDy);
+                overlay->push_back(makeLinePrimitive(perpPoint1, perpPoint2, orange, lineThickness));
 
-            const std::string scoreStr = std::to_string(score);
-            putText(sheetMat, scoreStr, impactInt, cv::FONT_HERSHEY_SIMPLEX, 2, black, 20);
-            putText(sheetMat, scoreStr, impactInt, cv::FONT_HERSHEY_SIMPLEX, 2, white, 10);
+                // Score en blanc avec un contour noir
+                const std::string scoreStr = std::to_string(score);
+                overlay->push_back(makeLabelPrimitive(scoreStr, impactInt, fontScale, black, outlineThickness));
+                overlay->push_back(makeLabelPrimitive(scoreStr, impactInt, fontScale, white, labelThickness));
+            }
 
             points.emplace_back(realDistance, score, closestZone, toDegrees(radAngle) + 180.0f, 1);
         }
+    }
+
+    TargetBatch getTargetBatch(const std::map<int, Ellipse> &targetsEllipsis) {
+        TargetBatch batch;
+        for (const auto &[zone, ellipse]: targetsEllipsis) {
+            batch.add(zone, ellipse.center().x, ellipse.center().y, ellipse.axes().width, ellipse.axes().height);
+        }
+        return batch;
+    }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour drawAndGetImpactsPoints: " << elapsed.count() << " secondes" << std::endl;
+    std::vector<Impact> drawAndGetImpactsPoints(const std::vector<cv::Point2f> &impacts, cv::Mat &sheetMat,
+                                              const std::map<int, Ellipse> &targetsEllipsis) {
+        SUBVISION_TRACE_SCOPE("drawAndGetImpactsPoints");
+        std::vector<OverlayPrimitive> overlay;
+        std::vector<Impact> points = scoreImpacts(impacts, targetsEllipsis, &overlay);
+        drawOverlay(overlay, sheetMat);
         return points;
     }
 
+    void fillImpactResults(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                           const std::vector<cv::Point2f> &impactsCoordinates, const ProcessingOptions &options,
+                           ImpactResults &results) {
+        const Status status = tryFillImpactResults(analysis, targetsEllipsis, impactsCoordinates, options, results);
+        if (!status) {
+            raiseError(status.error().message);
+        }
+    }
+
+    Status tryFillImpactResults(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                const std::vector<cv::Point2f> &impactsCoordinates, const ProcessingOptions &options,
+                                ImpactResults &results) {
+        const AnnotationMode mode = options.annotationMode;
+        // Les conteneurs des résultats gardent leur capacité quand l'appelant les réutilise
+        std::vector<OverlayPrimitive> &overlay = results.overlay;
+        overlay.clear();
+        std::vector<OverlayPrimitive> *annotation = mode == AnnotationMode::NONE ? nullptr : &overlay;
+
+        if (annotation) {
+            appendTargetsOverlay(targetsEllipsis, overlay);
+        }
+        // Annotation à l'échelle de la feuille du profil de résolution
+        const float scale = static_cast<float>(analysis.sheet.cols) / REFERENCE_SHEET_SIZE;
+        scoreImpacts(impactsCoordinates, targetsEllipsis, results.impacts, annotation, scale);
+        if (&results.targets != &targetsEllipsis) {
+            assignEllipses(targetsEllipsis, results.targets);
+        }
+
+        switch (mode) {
+            case AnnotationMode::RASTER: {
+                cv::Mat sheetMat = analysis.sheet;
+                drawOverlay(overlay, sheetMat);
+                results.annotatedImage = sheetMat;
+                results.overlay.clear();
+                break;
+            }
+            case AnnotationMode::VECTOR:
+                results.annotatedImage = analysis.sheet;
+                break;
+            case AnnotationMode::NONE:
+                results.annotatedImage.release();
+                results.overlay.clear();
+                break;
+        }
+
+        // Image encodée à la place de l'image brute, sauf si les deux sont demandées
+        const Status encoded = tryEncodeImage(results.annotatedImage, options.encoding, results.encodedImage);
+        if (!encoded) {
+            return encoded;
+        }
+        if (!results.encodedImage.empty() && !options.encoding.keepImage) {
+            results.annotatedImage.release();
+        }
+        return {};
+    }
+
     bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results) {
+        return retrieveImpacts(imageToProcess, results, ProcessingOptions());
+    }
+
+    bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options) {
+        ProcessingContext context;
+        return retrieveImpacts(imageToProcess, results, options, context);
+    }
 
-        cv::Mat sheetMat = getSheetPicture(imageToProcess.clone());
+    bool retrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options,
+                         ProcessingContext &context) {
+        return checkStatus(tryRetrieveImpacts(imageToProcess, results, options, context));
+    }
 
-        // Resize to standard dimensions if needed
-        if (sheetMat.cols != PICTURE_WIDTH_SHEET_DETECTION || sheetMat.rows != PICTURE_HEIGHT_SHEET_DETECTION) {
-            resize(sheetMat, sheetMat, cv::Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION));
+    Status tryRetrieveImpacts(const cv::Mat &imageToProcess, ImpactResults &results, const ProcessingOptions &options,
+                              ProcessingContext &context) {
+        SUBVISION_TRACE_SCOPE("retrieveImpacts");
+        const Result<cv::Mat> sheet = tryGetSheetPicture(imageToProcess, context, options.sheetDetectionMode,
+                                                         options.resolution);
+        if (!sheet) {
+            return recordError(Unexpected(sheet.error()), results);
         }
+        const cv::Mat source = imageToProcess.type() == CV_8UC3 ? imageToProcess : cv::Mat();
+        return recordError(retrieveImpactsFromSheetPicture(*sheet, source, results, options, context), results);
+    }
 
-        // Get targets ellipses
-        std::map<int, Ellipse> targetsEllipsis = getTargetsEllipse(sheetMat);
-        targetsEllipsis = targetCoordinatesToSheetCoordinates(targetsEllipsis);
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results) {
+        return retrieveImpacts(image, results, ProcessingOptions());
+    }
 
-        // Get impacts coordinates
-        const std::vector<cv::Point2f> impactsCoordinates = getImpactsCoordinates(sheetMat);
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options) {
+        ProcessingContext context;
+        return retrieveImpacts(image, results, options, context);
+    }
 
-        // Draw targets
-        drawTargets(targetsEllipsis, sheetMat);
+    bool retrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options,
+                         ProcessingContext &context) {
+        return checkStatus(tryRetrieveImpacts(image, results, options, context));
+    }
 
-        // Draw impacts and get points
-        const std::vector<Impact> points = drawAndGetImpactsPoints(impactsCoordinates, sheetMat, targetsEllipsis);
+    Status tryRetrieveImpacts(const ImageBuffer &image, ImpactResults &results, const ProcessingOptions &options,
+                              ProcessingContext &context) {
+        SUBVISION_TRACE_SCOPE("retrieveImpacts");
+        const Result<cv::Mat> sheet = tryGetSheetPicture(image, context, options.sheetDetectionMode,
+                                                         options.resolution);
+        if (!sheet) {
+            return recordError(Unexpected(sheet.error()), results);
+        }
+        const cv::Mat source = image.format == PixelFormat::BGR ? getPlaneView(image, 0) : cv::Mat();
+        return recordError(retrieveImpactsFromSheetPicture(*sheet, source, results, options, context), results);
+    }
 
-        // Set results
-        results.annotatedImage = sheetMat; // Assign the encoded string
-        results.impacts = points;
+    bool retrieveImpactsFromSheet(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                  ImpactResults &results) {
+        return retrieveImpactsFromSheet(analysis, targetsEllipsis, results, ProcessingOptions());
+    }
+
+    bool retrieveImpactsFromSheet(const SheetAnalysis &analysis, const std::map<int, Ellipse> &targetsEllipsis,
+                                  ImpactResults &results, const ProcessingOptions &options) {
+        SUBVISION_TRACE_SCOPE("retrieveImpactsFromSheet");
+        // Get impacts coordinates
+        std::vector<cv::Point2f> impactsCoordinates;
+        getImpactsCenters(analysis.impacts, impactsCoordinates);
 
-        return true;
+        // Score impacts and annotate targets and impacts
+        return checkStatus(recordError(
+            tryFillImpactResults(analysis, targetsEllipsis, impactsCoordinates, options, results), results));
     }
 }
@@ -0,0 +1,174 @@
+#include "../include/morphology.h"
+
+#include <algorithm>
+#include <cstring>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "../include/processing_context.h"
+
+namespace subvision {
+    namespace {
+        // Érosion : minimum, les pixels hors de l'image valent 255
+        struct MinOp {
+            static constexpr uchar BORDER = 255;
+
+            static uchar apply(const uchar a, const uchar b) {
+                return std::min(a, b);
+            }
+
+#if CV_SIMD128
+            static cv::v_uint8x16 apply(const cv::v_uint8x16 &a, const cv::v_uint8x16 &b) {
+                return cv::v_min(a, b);
+            }
+#endif
+        };
+
+        // Dilatation : maximum, les pixels hors de l'image valent 0
+        struct MaxOp {
+            static constexpr uchar BORDER = 0;
+
+            static uchar apply(const uchar a, const uchar b) {
+                return std::max(a, b);
+            }
+
+#if CV_SIMD128
+            static cv::v_uint8x16 apply(const cv::v_uint8x16 &a, const cv::v_uint8x16 &b) {
+                return cv::v_max(a, b);
+            }
+#endif
+        };
+
+        template<typename Op>
+        void combineRows(const uchar *a, const uchar *b, uchar *out, const int width) {
+            int x = 0;
+#if CV_SIMD128
+            constexpr int lanes = cv::v_uint8x16::nlanes;
+            for (; x <= width - lanes; x += lanes) {
+                cv::v_store(out + x, Op::apply(cv::v_load(a + x), cv::v_load(b + x)));
+            }
+#endif
+            for (; x < width; ++x) {
+                out[x] = Op::apply(a[x], b[x]);
+            }
+        }
+
+        // Passe horizontale : la ligne bordée est découpée en blocs de la taille de la fenêtre, chaque fenêtre
+        // est le cumul depuis la fin de son premier bloc combiné au cumul depuis le début du bloc suivant
+        template<typename Op>
+        void filterRows(const cv::Mat &src, cv::Mat &dst, const int radius, std::vector<uchar> &line) {
+            const int cols = src.cols;
+            const int window = 2 * radius + 1;
+            const int padded = cols + 2 * radius;
+            line.resize(padded);
+            uchar *prefix = line.data();
+
+            for (int y = 0; y < src.rows; ++y) {
+                const uchar *in = src.ptr<uchar>(y);
+                uchar *out = dst.ptr<uchar>(y);
+                const auto value = [in, radius, cols](const int i) {
+                    return i < radius || i >= cols + radius ? Op::BORDER : in[i - radius];
+                };
+
+                int position = 0;
+                for (int i = 0; i < padded; ++i) {
+                    prefix[i] = position == 0 ? value(i) : Op::apply(prefix[i - 1], value(i));
+                    if (++position == window) {
+                        position = 0;
+                    }
+                }
+
+                // Parcours descendant : la sortie i n'écrase que des pixels déjà lus, src peut être dst
+                uchar suffix = Op::BORDER;
+                position = (padded - 1) % window;
+                for (int i = padded - 1; i >= 0; --i) {
+                    suffix = position == window - 1 || i == padded - 1 ? value(i) : Op::apply(suffix, value(i));
+                    if (i < cols) {
+                        out[i] = Op::apply(suffix, prefix[i + 2 * radius]);
+                    }
+                    position = position == 0 ? window - 1 : position - 1;
+                }
+            }
+        }
+
+        // Passe verticale sur place, même découpage par blocs de lignes entières (vectorisé sur la largeur)
+        template<typename Op>
+        void filterColumns(cv::Mat &image, const int radius, MorphologyBuffers &buffers) {
+            const int rows = image.rows;
+            const int cols = image.cols;
+            const int window = 2 * radius + 1;
+            const int padded = rows + 2 * radius;
+
+            cv::Mat prefix = getBufferView(buffers.prefix, cv::Size(cols, padded), CV_8UC1);
+            buffers.border.assign(cols, Op::BORDER);
+            buffers.line.resize(cols);
+            const uchar *border = buffers.border.data();
+            uchar *suffix = buffers.line.data();
+            const auto row = [&image, border, radius, rows](const int i) -> const uchar *{
+                return i < radius || i >= rows + radius ? border : image.ptr<uchar>(i - radius);
+            };
+
+            int position = 0;
+            for (int i = 0; i < padded; ++i) {
+                if (position == 0) {
+                    std::memcpy(prefix.ptr<uchar>(i), row(i), cols);
+                } else {
+                    combineRows<Op>(prefix.ptr<uchar>(i - 1), row(i), prefix.ptr<uchar>(i), cols);
+                }
+                if (++position == window) {
+                    position = 0;
+                }
+            }
+
+            position = (padded - 1) % window;
+            for (int i = padded - 1; i >= 0; --i) {
+                if (position == window - 1 || i == padded - 1) {
+                    std::memcpy(suffix, row(i), cols);
+                } else {
+                    combineRows<Op>(suffix, row(i), suffix, cols);
+                }
+                if (i < rows) {
+                    combineRows<Op>(suffix, prefix.ptr<uchar>(i + 2 * radius), image.ptr<uchar>(i), cols);
+                }
+                position = position == 0 ? window - 1 : position - 1;
+            }
+        }
+
+        template<typename Op>
+        void filterRect(const cv::Mat &src, cv::Mat &dst, const int radius, MorphologyBuffers &buffers) {
+            CV_Assert(src.type() == CV_8UC1 && radius >= 0);
+            dst.create(src.size(), CV_8UC1);
+            if (radius == 0 || src.empty()) {
+                if (src.data != dst.data) {
+                    src.copyTo(dst);
+                }
+                return;
+            }
+            filterRows<Op>(src, dst, radius, buffers.line);
+            filterColumns<Op>(dst, radius, buffers);
+        }
+    }
+
+    void erodeRect(const cv::Mat &src, cv::Mat &dst, const int radius, MorphologyBuffers &buffers) {
+        filterRect<MinOp>(src, dst, radius, buffers);
+    }
+
+    void dilateRect(const cv::Mat &src, cv::Mat &dst, const int radius, MorphologyBuffers &buffers) {
+        filterRect<MaxOp>(src, dst, radius, buffers);
+    }
+
+    void erodeRect(const cv::Mat &src, cv::Mat &dst, const int radius) {
+        MorphologyBuffers buffers;
+        erodeRect(src, dst, radius, buffers);
+    }
+
+    void dilateRect(const cv::Mat &src, cv::Mat &dst, const int radius) {
+        MorphologyBuffers buffers;
+        dilateRect(src, dst, radius, buffers);
+    }
+
+    void openCloseRect(const cv::Mat &src, cv::Mat &dst, const int radius, MorphologyBuffers &buffers) {
+        erodeRect(src, dst, radius, buffers);
+        dilateRect(dst, dst, 2 * radius, buffers);
+        erodeRect(dst, dst, radius, buffers);
+    }
+}
@@ -0,0 +1,47 @@
+#include "../include/processing_context.h"
+
+#include "../include/constants.h"
+#include "../include/utils.h"
+
+namespace subvision {
+    void ProcessingContext::reserve() {
+        reserve(ResolutionProfile::PRECISE);
+    }
+
+    void ProcessingContext::reserve(const ResolutionProfile resolution) {
+        const int side = getProcessingProfile(resolution).sheetSize;
+        const cv::Size size(side, side);
+        detectionImage.create(size, CV_8UC3);
+        lightness.create(size, CV_8UC1);
+        sheetMask.create(size, CV_8UC1);
+        sheet.create(size, CV_8UC3);
+        saturation.create(size, CV_8UC1);
+        impactsScratch.create(size, CV_8UC1);
+        impactsMask.create(size, CV_8UC1);
+        impactLabels.create(size, CV_32SC1);
+
+        for (const auto &zone: TARGET_ZONES) {
+            const cv::Size zoneSize = getTargetView(sheet, zone).size();
+            TargetBuffers &buffers = targets[zone];
+            buffers.value.create(zoneSize, CV_8UC1);
+            buffers.valueMask.create(zoneSize, CV_8UC1);
+            buffers.notImpacts.create(zoneSize, CV_8UC1);
+            buffers.close.create(zoneSize, CV_8UC1);
+            buffers.filled.create(zoneSize, CV_8UC1);
+            buffers.ellipsePoints.reserve(360);
+        }
+        ellipsePoints.reserve(90);
+    }
+
+    void ProcessingContext::detachResults() {
+        sheet.release();
+        impactsMask.release();
+    }
+
+    cv::Mat getBufferView(cv::Mat &buffer, const cv::Size &size, const int type) {
+        if (buffer.type() != type || buffer.cols < size.width || buffer.rows < size.height) {
+            buffer.create(cv::Size(std::max(buffer.cols, size.width), std::max(buffer.rows, size.height)), type);
+        }
+        return buffer(cv::Rect(cv::Point(0, 0), size));
+    }
+}
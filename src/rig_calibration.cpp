@@ -0,0 +1,167 @@
+#include "../include/rig_calibration.h"
+
+#include "../include/constants.h"
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/sheet_detection.h"
+#include "../include/target_detection.h"
+#include "../include/trace.h"
+#include "../include/utils.h"
+
+namespace subvision {
+    namespace {
+        // Position dans l'image de chaque pixel de la feuille (même convention que warpPerspective), convertie
+        // en tables entières + indices d'interpolation : remap n'a plus de division par pixel
+        void buildRemapMaps(const cv::Mat &transform, const cv::Size &sheetSize, cv::Mat &mapXY,
+                            cv::Mat &mapInterpolation) {
+            SUBVISION_TRACE_SCOPE("buildRemapMaps");
+            const cv::Matx33d inverse = cv::Mat(transform.inv());
+            cv::Mat map(sheetSize, CV_32FC2);
+
+            for (int y = 0; y < map.rows; ++y) {
+                auto *row = map.ptr<cv::Vec2f>(y);
+                for (int x = 0; x < map.cols; ++x) {
+                    double w = inverse(2, 0) * x + inverse(2, 1) * y + inverse(2, 2);
+                    w = w != 0 ? 1.0 / w : 0.0;
+                    row[x] = cv::Vec2f(static_cast<float>((inverse(0, 0) * x + inverse(0, 1) * y + inverse(0, 2)) * w),
+                                       static_cast<float>((inverse(1, 0) * x + inverse(1, 1) * y + inverse(1, 2)) * w));
+                }
+            }
+            cv::convertMaps(map, cv::noArray(), mapXY, mapInterpolation, CV_16SC2);
+        }
+    }
+
+    RigCalibration::RigCalibration(const RigCalibrationOptions &options) : options(options) {
+    }
+
+    Status RigCalibration::calibrate(const cv::Mat &image) {
+        SheetAnalysis analysis;
+        return detect(image, analysis);
+    }
+
+    Status RigCalibration::detect(const cv::Mat &image, SheetAnalysis &analysis) {
+        SUBVISION_TRACE_SCOPE("RigCalibration::calibrate");
+        if (image.empty() || image.type() != CV_8UC3) {
+            return fail(ErrorCode::INVALID_IMAGE);
+        }
+        const Result<std::vector<cv::Point2f>> coordinates =
+                tryGetSheetCoordinates(image, context, options.processing.sheetDetectionMode,
+                                       options.processing.resolution);
+        if (!coordinates) {
+            return Unexpected(coordinates.error());
+        }
+        std::vector<cv::Point2f> detectedCorners = percentageToCoordinates(*coordinates, image.cols, image.rows);
+        const int side = getProcessingProfile(options.processing.resolution).sheetSize;
+        const cv::Size sheetSize(side, side);
+        Result<cv::Mat> transform = tryGetSheetTransform(detectedCorners, sheetSize);
+        if (!transform) {
+            return Unexpected(transform.error());
+        }
+
+        cv::Mat detectedMapXY, detectedMapInterpolation;
+        buildRemapMaps(*transform, sheetSize, detectedMapXY, detectedMapInterpolation);
+        cv::remap(image, context.sheet, detectedMapXY, detectedMapInterpolation, cv::INTER_LINEAR);
+
+        analysis = analyzeSheet(context.sheet, context);
+        analysis.source = image;
+        analysis.transform = *transform;
+        const Result<std::map<int, Ellipse>> targets = tryGetTargetsEllipse(analysis, options.processing, context);
+        if (!targets) {
+            return Unexpected(targets.error());
+        }
+
+        imageSize = image.size();
+        sheetCorners = std::move(detectedCorners);
+        sheetTransform = *transform;
+        sheetTargets = targetCoordinatesToSheetCoordinates(*targets, sheetSize);
+        mapXY = detectedMapXY;
+        mapInterpolation = detectedMapInterpolation;
+        storeCornerPatches(image, sheetCorners, options.patchRadius, patches);
+        score = 1.0f;
+        calibrated = true;
+        return {};
+    }
+
+    bool RigCalibration::processImage(const cv::Mat &image, ImpactResults &results) {
+        SUBVISION_TRACE_SCOPE("RigCalibration::processImage");
+        cached = calibrated && verify(image);
+
+        SheetAnalysis analysis;
+        Status status;
+        if (cached) {
+            // Géométrie enregistrée : ni détection de la feuille ni détection des cibles
+            cv::remap(image, context.sheet, mapXY, mapInterpolation, cv::INTER_LINEAR);
+            analysis = analyzeSheet(context.sheet, context);
+        } else if (options.recalibrate) {
+            status = detect(image, analysis);
+        } else {
+            return tryRetrieveImpacts(image, results, options.processing, context).has_value();
+        }
+
+        if (status) {
+            SUBVISION_TRACE_SCOPE("retrieveImpactsFromSheet");
+            getImpactsCenters(analysis.impacts, context.impactsCoordinates);
+            status = tryFillImpactResults(analysis, sheetTargets, context.impactsCoordinates, options.processing,
+                                          results);
+        }
+        results.error = status ? ProcessingError() : status.error();
+        return status.has_value();
+    }
+
+    bool RigCalibration::verify(const cv::Mat &image) {
+        SUBVISION_TRACE_SCOPE("RigCalibration::verify");
+        if (image.size() != imageSize || image.type() != CV_8UC3) {
+            return false;
+        }
+        std::vector<cv::Point2f> matched;
+        score = matchCornerPatches(image, sheetCorners, patches, options.searchRadius, matched);
+        if (score < options.minMatchScore) {
+            SUBVISION_LOG_DEBUG("Rig verification failed, score " << score);
+            return false;
+        }
+        for (std::size_t i = 0; i < matched.size(); ++i) {
+            if (getDistance(matched[i], sheetCorners[i]) > options.maxCornerShift) {
+                SUBVISION_LOG_DEBUG("Rig verification failed, corner " << i << " moved");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void RigCalibration::reset() {
+        imageSize = cv::Size();
+        sheetCorners.clear();
+        sheetTransform.release();
+        sheetTargets.clear();
+        patches.clear();
+        mapXY.release();
+        mapInterpolation.release();
+        score = 0;
+        calibrated = false;
+        cached = false;
+    }
+
+    bool RigCalibration::isCalibrated() const {
+        return calibrated;
+    }
+
+    bool RigCalibration::usedCalibration() const {
+        return cached;
+    }
+
+    float RigCalibration::verificationScore() const {
+        return score;
+    }
+
+    const std::vector<cv::Point2f> &RigCalibration::corners() const {
+        return sheetCorners;
+    }
+
+    const cv::Mat &RigCalibration::transform() const {
+        return sheetTransform;
+    }
+
+    const std::map<int, Ellipse> &RigCalibration::targets() const {
+        return sheetTargets;
+    }
+}
@@ -0,0 +1,123 @@
+#include "../include/scoring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace subvision {
+    namespace {
+        // Même valeur que SUBVISION_ZONE_UNDEFINED, sans dépendre d'OpenCV
+        constexpr int UNDEFINED_ZONE = -1;
+        constexpr float PI = 3.14159265f;
+        constexpr float RAD_TO_DEG = 180.0f / 3.14159265358979323846f;
+        constexpr float SCORING_RADIUS_FACTOR = TARGET_SCORING_GROWTH * 0.5f;
+
+        // Indice de la cible la plus proche de chaque impact (centres flottants), une passe par cible
+        void findNearestTargets(const float *px, const float *py, const std::size_t count,
+                                const TargetBatch &targets, ScoreBatch &results) {
+            float *nearest = results.nearest.data();
+            int *indices = results.zones.data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                nearest[i] = std::numeric_limits<float>::max();
+                indices[i] = 0;
+            }
+            for (std::size_t t = 0; t < targets.size(); ++t) {
+                const float cx = targets.centerX[t];
+                const float cy = targets.centerY[t];
+                const int index = static_cast<int>(t);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const float dx = px[i] - cx;
+                    const float dy = py[i] - cy;
+                    const float distanceSq = dx * dx + dy * dy;
+                    const bool closer = distanceSq < nearest[i];
+                    nearest[i] = closer ? distanceSq : nearest[i];
+                    indices[i] = closer ? index : indices[i];
+                }
+            }
+        }
+    }
+
+    void TargetBatch::add(const int zone, const float x, const float y, const float axisWidth,
+                          const float axisHeight) {
+        zones.push_back(zone);
+        centerX.push_back(x);
+        centerY.push_back(y);
+        width.push_back(axisWidth);
+        height.push_back(axisHeight);
+    }
+
+    std::size_t TargetBatch::size() const {
+        return zones.size();
+    }
+
+    void TargetBatch::clear() {
+        zones.clear();
+        centerX.clear();
+        centerY.clear();
+        width.clear();
+        height.clear();
+    }
+
+    std::size_t ScoreBatch::size() const {
+        return scores.size();
+    }
+
+    void scoreImpactBatch(const std::vector<float> &x, const std::vector<float> &y, const TargetBatch &targets,
+                          ScoreBatch &results) {
+        scoreImpactBatch(x.data(), y.data(), std::min(x.size(), y.size()), targets, results);
+    }
+
+    void scoreImpactBatch(const float *x, const float *y, const std::size_t count, const TargetBatch &targets,
+                          ScoreBatch &results) {
+        results.zones.resize(count);
+        results.distances.resize(count);
+        results.scores.resize(count);
+        results.angles.resize(count);
+        results.nearest.resize(count);
+
+        if (targets.size() == 0) {
+            std::fill(results.zones.begin(), results.zones.end(), UNDEFINED_ZONE);
+            std::fill(results.distances.begin(), results.distances.end(), 0);
+            std::fill(results.scores.begin(), results.scores.end(), 0);
+            std::fill(results.angles.begin(), results.angles.end(), 0.0f);
+            return;
+        }
+
+        findNearestTargets(x, y, count, targets, results);
+
+        // Centre tronqué au pixel et demi-axes de l'ellipse agrandie, comme scoreImpacts. Avec (dx, dy) le
+        // vecteur centre -> impact et r sa norme, le point de l'ellipse dans cette direction est à la distance
+        // sqrt(dx²a² + dy²b²) / r du centre : la distance réelle vaut 45 r² / sqrt(dx²a² + dy²b²)
+        for (std::size_t i = 0; i < count; ++i) {
+            const int t = results.zones[i];
+            const float cx = static_cast<float>(static_cast<int>(targets.centerX[t]));
+            const float cy = static_cast<float>(static_cast<int>(targets.centerY[t]));
+            const float a = targets.width[t] * SCORING_RADIUS_FACTOR;
+            const float b = targets.height[t] * SCORING_RADIUS_FACTOR;
+
+            const float dx = x[i] - cx;
+            const float dy = y[i] - cy;
+            const float radiusSq = dx * dx + dy * dy;
+            const float borderSq = dx * dx * a * a + dy * dy * b * b;
+            const float millimeters = borderSq > 0 ? TARGET_REAL_RADIUS * radiusSq / std::sqrt(borderSq) : 0.0f;
+            const int distance = static_cast<int>(std::lrint(millimeters));
+
+            results.distances[i] = distance;
+            results.scores[i] = lookupScore(distance);
+        }
+
+        // Seul calcul trigonométrique, dans sa propre boucle
+        for (std::size_t i = 0; i < count; ++i) {
+            const int t = results.zones[i];
+            // Vecteur impact -> centre, comme getAngle (atan2(+0, +0) pour un impact au centre)
+            const float dx = static_cast<float>(static_cast<int>(targets.centerX[t])) - x[i];
+            const float dy = static_cast<float>(static_cast<int>(targets.centerY[t])) - y[i];
+            results.angles[i] = (std::atan2(dy, dx) + PI) * RAD_TO_DEG + 180.0f;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            results.zones[i] = targets.zones[results.zones[i]];
+        }
+    }
+}
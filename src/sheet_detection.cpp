@@ -3,81 +3,398 @@
 //
 
 #include "sheet_detection.h"
+#include <cmath>
 #include <opencv2/opencv.hpp>
 #include <vector>
 
+#include "color_kernels.h"
 #include "constants.h"
+#include "image_buffer.h"
 #include "image_processing.h"
+#include "result.h"
+#include "trace.h"
 #include "utils.h"
 using namespace cv;
 using namespace std;
 namespace subvision {
+    namespace {
+        // Rayon minimal de la fenêtre de raffinement d'un coin, en pixels de l'image d'origine
+        constexpr int CORNER_REFINE_MIN_RADIUS = 8;
 
+        // Contour de la feuille sur le canal de luminosité à la résolution de détection
+        Result<std::vector<Point>> getSheetContour(const Mat& light, double minVal, double maxVal,
+                                                   ProcessingContext& context) {
+            maxVal = std::max(maxVal, 120.0);
+            minVal = (maxVal - minVal) * 0.5 + minVal;
 
+            Mat mask = getBufferView(context.sheetMask, light.size(), CV_8UC1);
+            inRange(light, cv::Scalar(minVal), cv::Scalar(maxVal), mask);
 
+            std::vector<std::vector<cv::Point>>& contours = context.contours;
+            findContours(mask, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
 
-    std::vector<Point2f> getSheetCoordinates(const Mat& sheet_mat) {
-        const auto start = std::chrono::high_resolution_clock::now();
-        Mat mat_resized;
-        resize(sheet_mat, mat_resized, Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION));
+            auto biggest = getBiggestValidContour(contours, light.size());
+
+            if (biggest.empty()) {
+                SUBVISION_LOG_WARNING("No valid sheet contour among " << contours.size() << " contours");
+                return fail(ErrorCode::NO_SHEET);
+            }
+            return biggest;
+        }
+
+        Result<std::vector<Point2f>> getSheetCoordinatesFromLightness(const Mat& light, const double minVal,
+                                                                      const double maxVal,
+                                                                      ProcessingContext& context) {
+            const auto contour = getSheetContour(light, minVal, maxVal, context);
+            if (!contour) {
+                return Unexpected(contour.error());
+            }
+            return coordinatesToPercentage(*contour, light.cols, light.rows);
+        }
+
+        // Image réduite de la détection rapide, proportions conservées
+        Size getProxySize(const Size& size) {
+            const double scale = std::min(1.0, static_cast<double>(PROXY_SHEET_DETECTION_SIZE) /
+                                               std::max(size.width, size.height));
+            return {std::max(1, cvRound(size.width * scale)), std::max(1, cvRound(size.height * scale))};
+        }
+
+        // Coins trouvés sur l'image réduite, raffinés au sous-pixel dans une fenêtre de l'image d'origine
+        // (niveaux de gris ou BGR/BGRA) dont la taille ne dépend que du facteur de réduction
+        Result<std::vector<Point2f>> getProxySheetCoordinates(const Mat& image, const Mat& light,
+                                                              const double minVal, const double maxVal,
+                                                              ProcessingContext& context) {
+            const auto contour = getSheetContour(light, minVal, maxVal, context);
+            if (!contour) {
+                return Unexpected(contour.error());
+            }
+
+            SUBVISION_TRACE_SCOPE("refineSheetCorners");
+            const float scaleX = static_cast<float>(image.cols) / static_cast<float>(light.cols);
+            const float scaleY = static_cast<float>(image.rows) / static_cast<float>(light.rows);
+            // Un pixel de l'image réduite couvre scale pixels : le coin est cherché à ±2 pixels réduits
+            const int radius = std::max(CORNER_REFINE_MIN_RADIUS,
+                                        static_cast<int>(std::ceil(2.0f * std::max(scaleX, scaleY))));
+            const Rect bounds(0, 0, image.cols, image.rows);
+            const TermCriteria criteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.01);
+
+            std::vector<Point2f> coordinates;
+            coordinates.reserve(contour->size());
+            for (const auto& point : *contour) {
+                // Centre du pixel réduit dans l'image d'origine
+                const Point2f corner((static_cast<float>(point.x) + 0.5f) * scaleX - 0.5f,
+                                     (static_cast<float>(point.y) + 0.5f) * scaleY - 0.5f);
+                const Rect window = Rect(cvRound(corner.x) - 2 * radius, cvRound(corner.y) - 2 * radius,
+                                         4 * radius + 1, 4 * radius + 1) & bounds;
+                // cornerSubPix exige une image d'au moins 2 * win + 5 pixels de côté
+                const int win = std::min(radius, (std::min(window.width, window.height) - 5) / 2);
 
-        Mat hls;
-        cvtColor(mat_resized, hls, COLOR_BGR2HLS);
+                Point2f refined = corner;
+                if (win >= 2) {
+                    Mat gray = image(window);
+                    if (image.channels() != 1) {
+                        cvtColor(gray, context.cornerWindow, image.channels() == 4 ? COLOR_BGRA2GRAY : COLOR_BGR2GRAY);
+                        gray = context.cornerWindow;
+                    }
+                    std::vector<Point2f>& local = context.cornerPoint;
+                    local.assign(1, corner - Point2f(window.tl()));
+                    cornerSubPix(gray, local, Size(win, win), Size(-1, -1), criteria);
+                    const Point2f candidate = local[0] + Point2f(window.tl());
+                    // Un déplacement plus grand que la fenêtre signale un autre coin (impact, ombre) : ignoré
+                    if (std::isfinite(candidate.x) && std::isfinite(candidate.y) &&
+                        norm(candidate - corner) <= static_cast<double>(radius)) {
+                        refined = candidate;
+                    }
+                }
+                coordinates.emplace_back(refined.x / static_cast<float>(image.cols),
+                                         refined.y / static_cast<float>(image.rows));
+            }
+            return coordinates;
+        }
+
+        // Redressement de la feuille, l'homographie utilisée est conservée dans transform
+        Status warpSheet(const Mat& image, const std::vector<Point2f>& real_coordinates, Mat& dst, Mat& transform,
+                         const Size& sheetSize = Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION)) {
+            SUBVISION_TRACE_SCOPE("warpSheet");
+            auto sheetTransform = tryGetSheetTransform(real_coordinates, sheetSize);
+            if (!sheetTransform) {
+                return Unexpected(sheetTransform.error());
+            }
+            transform = *sheetTransform;
+            warpPerspective(image, dst, transform, sheetSize);
+            return {};
+        }
+
+        Size getSheetSize(const ResolutionProfile resolution) {
+            const int size = getProcessingProfile(resolution).sheetSize;
+            return {size, size};
+        }
 
-        std::vector<Mat> channels(3);
-        split(hls, channels);
-        Mat &light = channels[1];
+        // Passage des coordonnées luma aux coordonnées chroma d'une image 4:2:0 (centres des pixels)
+        Mat getChromaTransform(const Mat& lumaTransform) {
+            const Mat toChroma = (Mat_<double>(3, 3) << 0.5, 0, -0.25, 0, 0.5, -0.25, 0, 0, 1);
+            return toChroma * lumaTransform * toChroma.inv();
+        }
+    }
+
+    std::vector<Point2f> getSheetCoordinates(const Mat& sheet_mat) {
+        ProcessingContext context;
+        return getSheetCoordinates(sheet_mat, context);
+    }
 
+    std::vector<Point2f> getSheetCoordinates(const Mat& sheet_mat, ProcessingContext& context) {
+        return valueOrRaise(tryGetSheetCoordinates(sheet_mat, context));
+    }
+
+    Result<std::vector<Point2f>> tryGetSheetCoordinates(const Mat& sheet_mat, ProcessingContext& context,
+                                                        const SheetDetectionMode mode,
+                                                        const ResolutionProfile resolution) {
+        SUBVISION_TRACE_SCOPE("getSheetCoordinates");
+        if (sheet_mat.empty() || sheet_mat.depth() != CV_8U || (sheet_mat.channels() != 3 && sheet_mat.channels() != 4)) {
+            return fail(ErrorCode::INVALID_IMAGE);
+        }
         double minVal, maxVal;
-        minMaxLoc(light, &minVal, &maxVal);
+        if (mode == SheetDetectionMode::PROXY) {
+            // Interpolation bilinéaire : quatre pixels lus par pixel réduit, quelle que soit la taille de la photo.
+            // L'imprécision du contour est corrigée par le raffinement des coins
+            const Size proxySize = getProxySize(sheet_mat.size());
+            Mat proxy = getBufferView(context.detectionImage, proxySize, sheet_mat.type());
+            resize(sheet_mat, proxy, proxySize, 0, 0, INTER_LINEAR);
+
+            Mat light = getBufferView(context.lightness, proxySize, CV_8UC1);
+            extractLightness(proxy, light, &minVal, &maxVal);
+            return getProxySheetCoordinates(sheet_mat, light, minVal, maxVal, context);
+        }
 
-        maxVal = std::max(maxVal, 120.0);
-        minVal = (maxVal - minVal) * 0.5 + minVal;
+        Mat& mat_resized = context.detectionImage;
+        resize(sheet_mat, mat_resized, getSheetSize(resolution));
 
-        Mat mask;
-        inRange(light, cv::Scalar(minVal), cv::Scalar(maxVal), mask);
+        Mat& light = context.lightness;
+        extractLightness(mat_resized, light, &minVal, &maxVal);
 
-        std::cout << "Start find contours" << std::endl;
-        std::vector<std::vector<cv::Point>> contours;
-        findContours(mask, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-        std::cout << "End find contours" << std::endl;
+        return getSheetCoordinatesFromLightness(light, minVal, maxVal, context);
+    }
 
-        const auto biggest = getBiggestValidContour(contours);
-        std::cout << "Biggest contour size: " << biggest.size() << std::endl;
+    std::vector<Point2f> getSheetCoordinates(const ImageBuffer& image) {
+        ProcessingContext context;
+        return getSheetCoordinates(image, context);
+    }
+
+    std::vector<Point2f> getSheetCoordinates(const ImageBuffer& image, ProcessingContext& context) {
+        return valueOrRaise(tryGetSheetCoordinates(image, context));
+    }
 
-        if (biggest.empty()) {
-            cout << "No valid contour found" << endl;
-            throw std::runtime_error("No valid contour found");
+    Result<std::vector<Point2f>> tryGetSheetCoordinates(const ImageBuffer& image, ProcessingContext& context,
+                                                        const SheetDetectionMode mode,
+                                                        const ResolutionProfile resolution) {
+        const Status valid = validateImageBuffer(image);
+        if (!valid) {
+            return Unexpected(valid.error());
+        }
+        if (!isYuvFormat(image.format)) {
+            // La luminosité HLS ne dépend pas de l'ordre des canaux, RGBA est traité sans conversion
+            return tryGetSheetCoordinates(getPlaneView(image, 0), context, mode, resolution);
         }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour getSheetCoordinates: " << elapsed.count() << " secondes" << std::endl;
+        SUBVISION_TRACE_SCOPE("getSheetCoordinates");
+        // Le plan Y sert directement de canal de luminosité
+        const Mat luma = getPlaneView(image, 0);
+        double minVal, maxVal;
+        if (mode == SheetDetectionMode::PROXY) {
+            const Size proxySize = getProxySize(luma.size());
+            Mat light = getBufferView(context.lightness, proxySize, CV_8UC1);
+            resize(luma, light, proxySize, 0, 0, INTER_LINEAR);
+            minMaxLoc(light, &minVal, &maxVal);
+            return getProxySheetCoordinates(luma, light, minVal, maxVal, context);
+        }
+
+        Mat& light = context.lightness;
+        resize(luma, light, getSheetSize(resolution));
+        minMaxLoc(light, &minVal, &maxVal);
 
-        return coordinatesToPercentage(biggest, PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION);
+        return getSheetCoordinatesFromLightness(light, minVal, maxVal, context);
     }
 
     // Recadrage du plastron à partir de l'image initiale
     Mat getSheetPicture(const Mat& image) {
-        const auto coordinates = getSheetCoordinates(image);
-        if (coordinates.empty()) {
-            throw std::runtime_error("Sheet coordinates not found");
+        ProcessingContext context;
+        return getSheetPicture(image, context);
+    }
+
+    Mat getSheetPicture(const Mat& image, ProcessingContext& context) {
+        return valueOrRaise(tryGetSheetPicture(image, context));
+    }
+
+    Result<Mat> tryGetSheetPicture(const Mat& image, ProcessingContext& context, const SheetDetectionMode mode,
+                                   const ResolutionProfile resolution) {
+        SUBVISION_TRACE_SCOPE("getSheetPicture");
+        const auto coordinates = tryGetSheetCoordinates(image, context, mode, resolution);
+        if (!coordinates) {
+            return Unexpected(coordinates.error());
         }
         const int height = image.rows;
         const int width = image.cols;
-        const auto real_coordinates = percentageToCoordinates(coordinates, width, height);
+        const Status warped = warpSheet(image, percentageToCoordinates(*coordinates, width, height), context.sheet,
+                                        context.sheetTransform, getSheetSize(resolution));
+        if (!warped) {
+            return Unexpected(warped.error());
+        }
+        return context.sheet;
+    }
+
+    Mat getSheetPicture(const ImageBuffer& image) {
+        ProcessingContext context;
+        return getSheetPicture(image, context);
+    }
+
+    Mat getSheetPicture(const ImageBuffer& image, ProcessingContext& context) {
+        return valueOrRaise(tryGetSheetPicture(image, context));
+    }
+
+    // Recadrage sans conversion de l'image complète : seuls les pixels de la feuille redressée sont convertis en BGR
+    Result<Mat> tryGetSheetPicture(const ImageBuffer& image, ProcessingContext& context,
+                                   const SheetDetectionMode mode, const ResolutionProfile resolution) {
+        SUBVISION_TRACE_SCOPE("getSheetPicture");
+        const auto coordinates = tryGetSheetCoordinates(image, context, mode, resolution);
+        if (!coordinates) {
+            return Unexpected(coordinates.error());
+        }
+        const auto corners = percentageToCoordinates(*coordinates, image.width, image.height);
+        const Size sheetSize = getSheetSize(resolution);
+
+        Mat& result = context.sheet;
+        Status warped;
+        switch (image.format) {
+            case PixelFormat::BGR:
+                warped = warpSheet(getPlaneView(image, 0), corners, result, context.sheetTransform, sheetSize);
+                if (!warped) {
+                    return Unexpected(warped.error());
+                }
+                return result;
+            case PixelFormat::RGBA:
+                warped = warpSheet(getPlaneView(image, 0), corners, context.warped, context.sheetTransform,
+                                   sheetSize);
+                if (!warped) {
+                    return Unexpected(warped.error());
+                }
+                cvtColor(context.warped, result, COLOR_RGBA2BGR);
+                return result;
+            default:
+                break;
+        }
+
+        // YUV 4:2:0 : chaque plan est redressé séparément, la chrominance à demi-résolution
+        const Size lumaSize = sheetSize;
+        const Size chromaSize(lumaSize.width / 2, lumaSize.height / 2);
+        auto transform = tryGetSheetTransform(corners, sheetSize);
+        if (!transform) {
+            return Unexpected(transform.error());
+        }
+        context.sheetTransform = *transform;
+        const Mat chromaTransform = getChromaTransform(*transform);
+        const Scalar neutralChroma(128, 128);
+
+        if (image.format == PixelFormat::I420) {
+            // Les trois plans sont écrits directement dans le buffer contigu attendu par cvtColor
+            Mat& yuv = context.yuv;
+            yuv.create(lumaSize.height * 3 / 2, lumaSize.width, CV_8UC1);
+            const size_t lumaArea = static_cast<size_t>(lumaSize.area());
+            Mat y = yuv.rowRange(0, lumaSize.height);
+            Mat u(chromaSize, CV_8UC1, yuv.data + lumaArea);
+            Mat v(chromaSize, CV_8UC1, yuv.data + lumaArea + lumaArea / 4);
+            warpPerspective(getPlaneView(image, 0), y, *transform, lumaSize);
+            warpPerspective(getPlaneView(image, 1), u, chromaTransform, chromaSize, INTER_LINEAR, BORDER_CONSTANT,
+                            neutralChroma);
+            warpPerspective(getPlaneView(image, 2), v, chromaTransform, chromaSize, INTER_LINEAR, BORDER_CONSTANT,
+                            neutralChroma);
+            cvtColor(yuv, result, COLOR_YUV2BGR_I420);
+            return result;
+        }
+
+        Mat& y = context.lightness;
+        Mat& uv = context.uv;
+        warpPerspective(getPlaneView(image, 0), y, *transform, lumaSize);
+        warpPerspective(getPlaneView(image, 1), uv, chromaTransform, chromaSize, INTER_LINEAR, BORDER_CONSTANT,
+                        neutralChroma);
+        cvtColorTwoPlane(y, uv, result, image.format == PixelFormat::NV12 ? COLOR_YUV2BGR_NV12 : COLOR_YUV2BGR_NV21);
+        return result;
+    }
+
+    Mat getSheetTransform(const std::vector<Point2f>& real_coordinates) {
+        return valueOrRaise(tryGetSheetTransform(real_coordinates));
+    }
+
+    Result<Mat> tryGetSheetTransform(const std::vector<Point2f>& real_coordinates) {
+        return tryGetSheetTransform(real_coordinates, Size(PICTURE_WIDTH_SHEET_DETECTION,
+                                                           PICTURE_HEIGHT_SHEET_DETECTION));
+    }
+
+    Result<Mat> tryGetSheetTransform(const std::vector<Point2f>& real_coordinates, const Size& sheetSize) {
+        const float width = static_cast<float>(sheetSize.width);
+        const float height = static_cast<float>(sheetSize.height);
         const std::vector<cv::Point2f> target = {
             {0, 0},
-            {PICTURE_WIDTH_SHEET_DETECTION, 0},
-            {PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION},
-            {0, PICTURE_HEIGHT_SHEET_DETECTION}
+            {width, 0},
+            {width, height},
+            {0, height}
         };
-        if (real_coordinates.size() != 4 || target.size() != 4) {
-            throw std::runtime_error("getPerspectiveTransform nécessite exactement 4 points source et 4 points cible.");
+        if (real_coordinates.size() != target.size()) {
+            return fail(ErrorCode::DEGENERATE_HOMOGRAPHY);
         }
-        const Mat transform = getPerspectiveTransform(real_coordinates, target);
+        // Coins alignés ou confondus : le système est singulier et l'homographie n'est pas inversible
+        Mat transform = getPerspectiveTransform(real_coordinates, target);
+        const double det = determinant(transform);
+        if (!std::isfinite(det) || std::abs(det) < 1e-12) {
+            return fail(ErrorCode::DEGENERATE_HOMOGRAPHY);
+        }
+        return transform;
+    }
+
+    Mat warpSheet(const Mat& image, const std::vector<Point2f>& real_coordinates) {
         Mat result;
-        warpPerspective(image, result, transform, Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION));
+        warpSheet(image, real_coordinates, result);
         return result;
     }
+
+    void warpSheet(const Mat& image, const std::vector<Point2f>& real_coordinates, Mat& dst) {
+        const Status status = tryWarpSheet(image, real_coordinates, dst);
+        if (!status) {
+            raiseError(status.error().message);
+        }
+    }
+
+    Status tryWarpSheet(const Mat& image, const std::vector<Point2f>& real_coordinates, Mat& dst,
+                        const ResolutionProfile resolution) {
+        Mat transform;
+        return warpSheet(image, real_coordinates, dst, transform, getSheetSize(resolution));
+    }
+
+    Mat getSheetRegionTransform(const Mat& transform, const Rect& region, const Size& size) {
+        const double scaleX = static_cast<double>(size.width) / region.width;
+        const double scaleY = static_cast<double>(size.height) / region.height;
+        // Feuille vers tuile, centres des pixels alignés comme avec resize
+        const Mat toRegion = (Mat_<double>(3, 3) << scaleX, 0, scaleX * (0.5 - region.x) - 0.5,
+                              0, scaleY, scaleY * (0.5 - region.y) - 0.5,
+                              0, 0, 1);
+        return toRegion * transform;
+    }
+
+    void warpSheetRegion(const Mat& image, const Mat& transform, const Rect& region, const Size& size, Mat& dst) {
+        SUBVISION_TRACE_SCOPE("warpSheetRegion");
+        warpPerspective(image, dst, getSheetRegionTransform(transform, region, size), size);
+    }
+
+    Mat getSheetZoneTransform(const Mat& transform, const int zone, const double scale,
+                              const ResolutionProfile resolution) {
+        const int sheetSize = getProcessingProfile(resolution).sheetSize;
+        const Rect rect = getCropCoordinates(Size(sheetSize, sheetSize), zone);
+        return getSheetRegionTransform(transform, rect, Size(cvRound(rect.width * scale), cvRound(rect.height * scale)));
+    }
+
+    void warpSheetZone(const Mat& image, const Mat& transform, const int zone, const double scale, Mat& dst,
+                       const ResolutionProfile resolution) {
+        const int sheetSize = getProcessingProfile(resolution).sheetSize;
+        const Rect rect = getCropCoordinates(Size(sheetSize, sheetSize), zone);
+        warpSheetRegion(image, transform, rect, Size(cvRound(rect.width * scale), cvRound(rect.height * scale)), dst);
+    }
 }
@@ -1,217 +1,446 @@
 #include "../include/target_detection.h"
 
+#include <algorithm>
+#include <cmath>
 #include <future>
 
+#include "../include/annotation.h"
+#include "../include/color_kernels.h"
 #include "../include/constants.h"
 #include "../include/utils.h"
 #include "../include/image_processing.h"
+#include "../include/morphology.h"
+#include "../include/result.h"
+#include "../include/sheet_detection.h"
+#include "../include/thread_pool.h"
+#include "../include/trace.h"
 
 namespace subvision {
-    Ellipse getTargetEllipse(const cv::Mat &mat) {
-        const auto start = std::chrono::high_resolution_clock::now();
-
-        cv::Mat circle = cv::Mat::zeros(mat.rows, mat.cols, CV_8UC1);
-        const cv::Point centerPoint(mat.cols / 2, mat.rows / 2);
-        const int radius = static_cast<int>(mat.cols / 2.2);
-        cv::circle(circle, centerPoint, radius, cv::Scalar(255), -1);
-
-        cv::Mat xyz;
-        cvtColor(mat, xyz, cv::COLOR_BGR2XYZ);
-        std::vector<cv::Mat> xyzChannels(3);
-        split(xyz, xyzChannels);
-        cv::Mat &value = xyzChannels[2];
-
-        bitwise_not(value, value);
-        double minVal, maxVal;
-        minMaxLoc(value, &minVal, &maxVal);
-        minVal = maxVal - (maxVal - minVal) / 1.5;
-
-        cv::Mat valueMask;
-        inRange(value, cv::Scalar(minVal), cv::Scalar(maxVal), valueMask);
-
-        const cv::Mat impacts = getImpactsMask(mat);
-        cv::Mat notImpacts;
-        bitwise_not(impacts, notImpacts);
-        bitwise_and(valueMask, notImpacts, valueMask);
-
-        cv::Mat close, element;
-        cv::erode(valueMask, close, element, cv::Point(-1, -1), 10);
-        cv::dilate(close, close, element, cv::Point(-1, -1), 20);
-        cv::erode(close, close, element, cv::Point(-1, -1), 10);
-
-        Ellipse ellipse = retrieveEllipse(close);
-
-        auto ellipseIsValid = [](const Ellipse &e) {
-            const float w = std::get<1>(e).width;
-            const float h = std::get<1>(e).height;
+    namespace {
+        // Réduction et itérations de la pyramide : voir ProcessingProfile
+        // Bande de raffinement autour de l'ellipse grossière
+        constexpr float PYRAMID_BAND_INNER = 0.8f;
+        constexpr float PYRAMID_BAND_OUTER = 1.2f;
+        // Agrandissement de la fenêtre de recherche après chaque échec
+        constexpr double SEARCH_WINDOW_GROWTH = 1.5;
+        // Marge (pixels) en deçà de laquelle une ellipse est considérée coupée par le bord de la fenêtre
+        constexpr float SEARCH_WINDOW_MARGIN = 4.0f;
+
+        bool isValidTargetEllipse(const Ellipse &ellipse) {
+            const float w = ellipse.axes().width;
+            const float h = ellipse.axes().height;
             return w >= h * 0.7f && w <= h * 1.3f;
-        };
+        }
 
-        std::vector<cv::Point> ellipsePoints;
-        ellipsePoints.reserve(360);
+        // Canal Z inversé (les zones sombres du visuel ont les valeurs les plus hautes)
+        // et plage de seuillage calculés dans la même passe
+        void getInvertedZ(const cv::Mat &mat, cv::Mat &value, double &minVal, double &maxVal) {
+            extractInvertedZ(mat, value, &minVal, &maxVal);
+            minVal = maxVal - (maxVal - minVal) / 1.5;
+        }
+
+        void getValueMask(const cv::Mat &value, const cv::Mat &impactsMask, const double minVal,
+                          const double maxVal, cv::Mat &notImpacts, cv::Mat &valueMask) {
+            inRange(value, cv::Scalar(minVal), cv::Scalar(maxVal), valueMask);
+
+            bitwise_not(impactsMask, notImpacts);
+            bitwise_and(valueMask, notImpacts, valueMask);
+        }
 
-        try {
-            cv::Mat empty = cv::Mat::zeros(mat.size(), mat.type());
-            const cv::Point center = tupleIntCast(std::get<0>(ellipse));
-            const cv::Size2f size = std::get<1>(ellipse);
-            const float angle = std::get<2>(ellipse);
+        // Ouverture puis fermeture, équivalentes à l'élément 3x3 par défaut répété iterations fois
+        void closeMask(const cv::Mat &mask, const int iterations, cv::Mat &close, MorphologyBuffers &buffers) {
+            openCloseRect(mask, close, iterations, buffers);
+        }
 
+        // Ellipse pleine dans filled, déjà à la taille voulue
+        void getFilledEllipse(const Ellipse &ellipse, std::vector<cv::Point> &ellipsePoints, cv::Mat &filled) {
+            filled.setTo(cv::Scalar(0));
             ellipsePoints.clear();
-            ellipse2Poly(center, cv::Size2f(size.width * 0.5f, size.height * 0.5f), static_cast<int>(angle), 0, 360, 1,
-                         ellipsePoints);
-            fillConvexPoly(empty, ellipsePoints, cv::Scalar(255, 255, 255));
+            ellipse2Poly(tupleIntCast(ellipse.center()), cv::Size2f(ellipse.halfWidth(), ellipse.halfHeight()),
+                         static_cast<int>(ellipse.angle()), 0, 360, 1, ellipsePoints);
+            fillConvexPoly(filled, ellipsePoints, cv::Scalar(255));
+        }
 
-            cv::Mat emptyGray;
-            cvtColor(empty, emptyGray, cv::COLOR_BGR2GRAY);
+        // Ajustement de l'ellipse sur le masque fermé, en comblant d'abord les trous du visuel
+        Result<Ellipse> fitTargetEllipse(cv::Mat &close, TargetBuffers &buffers, const int zone) {
+            Ellipse ellipse = retrieveEllipse(close, buffers.contours);
+            cv::Mat filled = getBufferView(buffers.filled, close.size(), CV_8UC1);
 
-            cv::Mat xor_;
-            bitwise_xor(emptyGray, close, xor_);
-            bitwise_or(close, xor_, close);
+            getFilledEllipse(ellipse, buffers.ellipsePoints, filled);
 
-            ellipse = retrieveEllipse(close);
+            // close | (filled ^ close) : les trous du visuel sont comblés par l'ellipse
+            bitwise_or(close, filled, close);
 
-            if (!ellipseIsValid(ellipse)) {
-                throw std::runtime_error("Problem during visual detection 1");
+            ellipse = retrieveEllipse(close, buffers.contours);
+            if (isValidTargetEllipse(ellipse)) {
+                return ellipse;
             }
-        } catch (const std::exception &) {
-            cv::Mat empty = cv::Mat::zeros(mat.size(), mat.type());
-            const cv::Point center = tupleIntCast(std::get<0>(ellipse));
-            const cv::Size2f size = std::get<1>(ellipse);
-            const float angle = std::get<2>(ellipse);
 
-            ellipsePoints.clear();
-            ellipse2Poly(center, cv::Size2f(size.width * 0.5f, size.height * 0.5f), static_cast<int>(angle), 0, 360, 1,
-                         ellipsePoints);
-            fillConvexPoly(empty, ellipsePoints, cv::Scalar(255, 255, 255));
+            // Sinon le masque est restreint à l'ellipse obtenue
+            getFilledEllipse(ellipse, buffers.ellipsePoints, filled);
+
+            bitwise_and(close, filled, close);
 
-            cv::Mat emptyGray;
-            cvtColor(empty, emptyGray, cv::COLOR_BGR2GRAY);
+            ellipse = retrieveEllipse(close, buffers.contours);
+
+            if (!isValidTargetEllipse(ellipse)) {
+                return fail(ErrorCode::INVALID_TARGET_ELLIPSE, zone);
+            }
+            return ellipse;
+        }
 
-            bitwise_and(close, emptyGray, close);
+        Result<Ellipse> detectTargetEllipse(const cv::Mat &mat, const cv::Mat &impactsMask, TargetBuffers &buffers,
+                                            const int zone, const ProcessingProfile &profile) {
+            SUBVISION_TRACE_SCOPE("getTargetEllipse");
+            const cv::Size size = mat.size();
 
-            ellipse = retrieveEllipse(close);
+            double minVal, maxVal;
+            cv::Mat value = getBufferView(buffers.value, size, CV_8UC1);
+            getInvertedZ(mat, value, minVal, maxVal);
 
-            if (!ellipseIsValid(ellipse)) {
-                throw std::runtime_error("Problem during visual detection");
+            cv::Mat valueMask = getBufferView(buffers.valueMask, size, CV_8UC1);
+            cv::Mat notImpacts = getBufferView(buffers.notImpacts, size, CV_8UC1);
+            getValueMask(value, impactsMask, minVal, maxVal, notImpacts, valueMask);
+
+            cv::Mat close = getBufferView(buffers.close, size, CV_8UC1);
+            closeMask(valueMask, profile.targetCloseIterations, close, buffers.morphology);
+
+            return fitTargetEllipse(close, buffers, zone);
+        }
+
+        // source, transform et region (facultatifs) : image d'origine, homographie vers la feuille et rectangle
+        // de la feuille couvert par mat, d'où l'image réduite est tirée directement au lieu de réduire mat
+        Result<Ellipse> detectTargetEllipsePyramid(const cv::Mat &mat, const cv::Mat &impactsMask,
+                                                   TargetBuffers &buffers, const int zone,
+                                                   const ProcessingProfile &profile,
+                                                   const cv::Mat &source = cv::Mat(),
+                                                   const cv::Mat &transform = cv::Mat(),
+                                                   const cv::Rect &region = cv::Rect()) {
+            SUBVISION_TRACE_SCOPE("getTargetEllipsePyramid");
+
+            // Niveau grossier : détection complète sur l'image réduite
+            const int factor = profile.pyramidFactor;
+            const cv::Size coarseSize(mat.cols / factor, mat.rows / factor);
+            cv::Mat coarse = getBufferView(buffers.coarse, coarseSize, mat.type());
+            cv::Mat coarseImpacts = getBufferView(buffers.coarseImpacts, coarseSize, impactsMask.type());
+            if (!source.empty() && !region.empty()) {
+                warpSheetRegion(source, transform, region, coarseSize, coarse);
+            } else {
+                resize(mat, coarse, coarseSize, 0, 0, cv::INTER_LINEAR);
             }
+            resize(impactsMask, coarseImpacts, coarseSize, 0, 0, cv::INTER_NEAREST);
+
+            double minVal, maxVal;
+            cv::Mat coarseValue = getBufferView(buffers.value, coarseSize, CV_8UC1);
+            getInvertedZ(coarse, coarseValue, minVal, maxVal);
+
+            cv::Mat coarseMask = getBufferView(buffers.valueMask, coarseSize, CV_8UC1);
+            cv::Mat notImpacts = getBufferView(buffers.notImpacts, coarseSize, CV_8UC1);
+            getValueMask(coarseValue, coarseImpacts, minVal, maxVal, notImpacts, coarseMask);
+
+            cv::Mat coarseClose = getBufferView(buffers.close, coarseSize, CV_8UC1);
+            closeMask(coarseMask, profile.pyramidCoarseIterations, coarseClose, buffers.morphology);
+            const Result<Ellipse> coarseEllipse = fitTargetEllipse(coarseClose, buffers, zone);
+            if (!coarseEllipse) {
+                return coarseEllipse;
+            }
+
+            const cv::Point2f coarseCenter = coarseEllipse->center();
+            const cv::Size2f coarseAxes = coarseEllipse->axes();
+            const cv::Point2f center((coarseCenter.x + 0.5f) * static_cast<float>(factor) - 0.5f,
+                                     (coarseCenter.y + 0.5f) * static_cast<float>(factor) - 0.5f);
+            const cv::Size2f axes(coarseAxes.width * static_cast<float>(factor),
+                                  coarseAxes.height * static_cast<float>(factor));
+
+            // Raffinement à pleine résolution, limité à une bande autour de l'ellipse grossière
+            const float radius = std::max(axes.width, axes.height) * 0.5f * PYRAMID_BAND_OUTER;
+            const cv::Rect roi = cv::Rect(cv::Point(cvFloor(center.x - radius), cvFloor(center.y - radius)),
+                                          cv::Point(cvCeil(center.x + radius) + 1, cvCeil(center.y + radius) + 1))
+                                 & cv::Rect(0, 0, mat.cols, mat.rows);
+            if (roi.empty()) {
+                return fail(ErrorCode::INVALID_TARGET_ELLIPSE, zone);
+            }
+
+            const cv::Point2f offset(static_cast<float>(roi.x), static_cast<float>(roi.y));
+            const Ellipse localEllipse(center - offset, axes, coarseEllipse->angle());
+            const cv::Size roiSize = roi.size();
+
+            cv::Mat value = getBufferView(buffers.value, roiSize, CV_8UC1);
+            extractInvertedZ(mat(roi), value);
+
+            cv::Mat band = getBufferView(buffers.valueMask, roiSize, CV_8UC1);
+            notImpacts = getBufferView(buffers.notImpacts, roiSize, CV_8UC1);
+            getValueMask(value, impactsMask(roi), minVal, maxVal, notImpacts, band);
+
+            cv::Mat filled = getBufferView(buffers.filled, roiSize, CV_8UC1);
+            getFilledEllipse(localEllipse.grown(PYRAMID_BAND_OUTER), buffers.ellipsePoints, filled);
+            bitwise_and(band, filled, band);
+            getFilledEllipse(localEllipse.grown(PYRAMID_BAND_INNER), buffers.ellipsePoints, filled);
+            bitwise_or(band, filled, band);
+
+            cv::Mat close = getBufferView(buffers.close, roiSize, CV_8UC1);
+            closeMask(band, profile.pyramidRefineIterations, close, buffers.morphology);
+            const Ellipse ellipse = retrieveEllipse(close, buffers.contours);
+            if (!isValidTargetEllipse(ellipse)) {
+                return fail(ErrorCode::INVALID_TARGET_ELLIPSE, zone);
+            }
+            return ellipse.translated(offset);
         }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Temps écoulé pour getTargetEllipse: " << elapsed.count() << " secondes" << std::endl;
-        return ellipse;
-    }
+        // Ellipse entièrement dans la fenêtre, sauf du côté des bords de la zone (au-delà il n'y a rien à voir)
+        bool isInsideSearchWindow(const Ellipse &ellipse, const cv::Rect &window, const cv::Rect &zoneRect) {
+            const cv::Point2f &center = ellipse.center();
+            const float radius = std::max(ellipse.halfWidth(), ellipse.halfHeight()) +
+                                 SEARCH_WINDOW_MARGIN;
+            return (window.x == zoneRect.x || center.x - radius >= 0) &&
+                   (window.y == zoneRect.y || center.y - radius >= 0) &&
+                   (window.br().x == zoneRect.br().x || center.x + radius <= static_cast<float>(window.width)) &&
+                   (window.br().y == zoneRect.br().y || center.y + radius <= static_cast<float>(window.height));
+        }
 
-    Ellipse getTargetEllipseForZone(const cv::Mat &image, int zone) {
-        return getTargetEllipse(getTargetPicture(image, zone));
-    }
+        Result<Ellipse> detectTargetInWindow(const SheetAnalysis &analysis, const cv::Rect &window, const int zone,
+                                             const TargetDetectionMode mode, TargetBuffers &buffers) {
+            const cv::Mat target = analysis.sheet(window);
+            const cv::Mat impactsMask = analysis.impactsMask(window);
+            const ProcessingProfile profile = getProcessingProfile(analysis.sheet.cols);
+
+            if (mode == TargetDetectionMode::PYRAMID) {
+                // Image d'origine utilisable seulement en BGR ; transform est l'homographie vers cette feuille
+                const bool direct = !analysis.source.empty() && analysis.source.type() == CV_8UC3 &&
+                                    !analysis.transform.empty();
+                return direct
+                           ? detectTargetEllipsePyramid(target, impactsMask, buffers, zone, profile, analysis.source,
+                                                        analysis.transform, window)
+                           : detectTargetEllipsePyramid(target, impactsMask, buffers, zone, profile);
+            }
+            return detectTargetEllipse(target, impactsMask, buffers, zone, profile);
+        }
 
-    std::map<int, Ellipse> getTargetsEllipse(const cv::Mat &image) {
-        const std::vector<int> zones = {
-            SUBVISION_ZONE_TOP_LEFT, SUBVISION_ZONE_TOP_RIGHT, SUBVISION_ZONE_CENTER,
-            SUBVISION_ZONE_BOTTOM_LEFT, SUBVISION_ZONE_BOTTOM_RIGHT
-        };
+        // Retirer les zones qui ne sont pas des cibles, les autres nœuds sont réutilisés par operator[]
+        void keepTargetZones(std::map<int, Ellipse> &ellipses) {
+            for (auto it = ellipses.begin(); it != ellipses.end();) {
+                const bool target = std::find(TARGET_ZONES.begin(), TARGET_ZONES.end(), it->first) !=
+                                    TARGET_ZONES.end();
+                it = target ? std::next(it) : ellipses.erase(it);
+            }
+        }
 
-        std::map<int, Ellipse> ellipses;
+        Status detectTargets(const SheetAnalysis &analysis, const TargetDetectionMode mode,
+                             std::array<TargetBuffers, 5> &buffers, std::map<int, Ellipse> &ellipses) {
+            SUBVISION_TRACE_SCOPE("getTargetsEllipse");
+            keepTargetZones(ellipses);
+
+            for (const auto &zone: TARGET_ZONES) {
+                Result<Ellipse> ellipse = tryGetTargetEllipseForZone(analysis, zone, mode, buffers[zone]);
+                if (!ellipse) {
+                    return Unexpected(ellipse.error());
+                }
+                ellipses[zone] = *ellipse;
+            }
 
-        for (const auto &zone: zones) {
-            ellipses[zone] = getTargetEllipseForZone(image, zone);
+            return {};
         }
 
-        return ellipses;
-    }
+        Status detectTargets(const SheetAnalysis &analysis, ThreadPool &pool, const TargetDetectionMode mode,
+                             std::array<TargetBuffers, 5> &buffers, std::map<int, Ellipse> &ellipses) {
+            SUBVISION_TRACE_SCOPE("getTargetsEllipse");
+            std::array<std::future<Result<Ellipse>>, 5> futures;
+
+            // Chaque tâche n'utilise que les buffers de sa zone
+            for (std::size_t i = 0; i < TARGET_ZONES.size(); ++i) {
+                const int zone = TARGET_ZONES[i];
+                TargetBuffers &zoneBuffers = buffers[zone];
+                futures[i] = pool.submit([&analysis, zone, mode, &zoneBuffers] {
+                    return tryGetTargetEllipseForZone(analysis, zone, mode, zoneBuffers);
+                });
+            }
 
-    std::map<int, Ellipse> targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses) {
-        std::map<int, Ellipse> newEllipses;
+            // Attendre toutes les zones avant de retourner une éventuelle erreur,
+            // les tâches référencent encore l'analyse et les buffers
+            for (const auto &future: futures) {
+                future.wait();
+            }
 
-        for (const auto &[key, value]: ellipses) {
-            cv::Point2f center = std::get<0>(value);
-            cv::Size2f size = std::get<1>(value);
-            float angle = std::get<2>(value);
-
-            if (key == SUBVISION_ZONE_TOP_LEFT) {
-                newEllipses[key] = std::make_tuple(center, size, angle);
-            } else if (key == SUBVISION_ZONE_BOTTOM_LEFT) {
-                newEllipses[key] = std::make_tuple(
-                    cv::Point2f(center.x, center.y + PICTURE_HEIGHT_SHEET_DETECTION / 2),
-                    size, angle
-                );
-            } else if (key == SUBVISION_ZONE_TOP_RIGHT) {
-                newEllipses[key] = std::make_tuple(
-                    cv::Point2f(center.x + PICTURE_WIDTH_SHEET_DETECTION / 2, center.y),
-                    size, angle
-                );
-            } else if (key == SUBVISION_ZONE_BOTTOM_RIGHT) {
-                newEllipses[key] = std::make_tuple(
-                    cv::Point2f(center.x + PICTURE_WIDTH_SHEET_DETECTION / 2,
-                                center.y + PICTURE_HEIGHT_SHEET_DETECTION / 2),
-                    size, angle
-                );
-            } else if (key == SUBVISION_ZONE_CENTER) {
-                newEllipses[key] = std::make_tuple(
-                    cv::Point2f(center.x + PICTURE_WIDTH_SHEET_DETECTION / 4,
-                                center.y + PICTURE_HEIGHT_SHEET_DETECTION / 4),
-                    size, angle
-                );
+            // Première erreur dans l'ordre des zones, comme en séquentiel
+            keepTargetZones(ellipses);
+            for (std::size_t i = 0; i < TARGET_ZONES.size(); ++i) {
+                Result<Ellipse> ellipse = futures[i].get();
+                if (!ellipse) {
+                    return Unexpected(ellipse.error());
+                }
+                ellipses[TARGET_ZONES[i]] = *ellipse;
             }
+
+            return {};
         }
+    }
 
-        return newEllipses;
+    Ellipse getTargetEllipse(const cv::Mat &mat) {
+        return getTargetEllipse(mat, getImpactsMask(mat));
     }
 
-    void drawTargets(const std::map<int, Ellipse> &coordinates, cv::Mat &sheetMat) {
-        constexpr int drawingWidth = 1;
-        const cv::Scalar targetColor(0, 0, 255);
-        constexpr float pi = 3.14159265f;
-        constexpr float halfPi = pi * 0.5f;
+    Ellipse getTargetEllipse(const cv::Mat &mat, const cv::Mat &impactsMask) {
+        TargetBuffers buffers;
+        return getTargetEllipse(mat, impactsMask, buffers);
+    }
+
+    Ellipse getTargetEllipse(const cv::Mat &mat, const cv::Mat &impactsMask, TargetBuffers &buffers) {
+        return valueOrRaise(detectTargetEllipse(mat, impactsMask, buffers, -1, PRECISE_PROFILE));
+    }
+
+    Ellipse getTargetEllipsePyramid(const cv::Mat &mat, const cv::Mat &impactsMask) {
+        TargetBuffers buffers;
+        return getTargetEllipsePyramid(mat, impactsMask, buffers);
+    }
+
+    Ellipse getTargetEllipsePyramid(const cv::Mat &mat, const cv::Mat &impactsMask, TargetBuffers &buffers) {
+        return valueOrRaise(detectTargetEllipsePyramid(mat, impactsMask, buffers, -1, PRECISE_PROFILE));
+    }
+
+    Ellipse getTargetEllipseForZone(const cv::Mat &image, int zone) {
+        return getTargetEllipse(getTargetView(image, zone));
+    }
+
+    Ellipse getTargetEllipseForZone(const SheetAnalysis &analysis, int zone, TargetDetectionMode mode) {
+        TargetBuffers buffers;
+        return getTargetEllipseForZone(analysis, zone, mode, buffers);
+    }
 
-        for (const auto &[_key, ellipseContrat]: coordinates) {
-            const Ellipse ellipseCrossTip = growEllipse(ellipseContrat, 2.2f);
-            const Ellipse ellipseMouche = growEllipse(ellipseContrat, 0.2f);
-            const Ellipse ellipsePetitBlanc = growEllipse(ellipseContrat, 0.6f);
-            const Ellipse ellipseMoyenBlanc = growEllipse(ellipseContrat, 1.4f);
-            const Ellipse ellipseGrandBlanc = growEllipse(ellipseContrat, 1.8f);
+    Ellipse getTargetEllipseForZone(const SheetAnalysis &analysis, int zone, TargetDetectionMode mode,
+                                    TargetBuffers &buffers) {
+        return valueOrRaise(tryGetTargetEllipseForZone(analysis, zone, mode, buffers));
+    }
 
-            const cv::Point center = tupleIntCast(std::get<0>(ellipseContrat));
-            const cv::Size2f size = std::get<1>(ellipseContrat);
-            const float angle = std::get<2>(ellipseContrat);
+    cv::Rect getTargetSearchWindow(const cv::Size &sheetSize, const int zone, const int growth) {
+        const cv::Rect zoneRect = getCropCoordinates(sheetSize, zone);
+        if (zone < 0 || zone >= static_cast<int>(TARGET_EXPECTED_CENTERS.size())) {
+            return zoneRect;
+        }
+        const double scale = static_cast<double>(sheetSize.width) / PICTURE_WIDTH_SHEET_DETECTION;
+        const cv::Point2f expected = TARGET_EXPECTED_CENTERS[zone];
+        const double radius = getProcessingProfile(sheetSize.width).targetSearchRadius *
+                              std::pow(SEARCH_WINDOW_GROWTH, growth);
+        const cv::Rect window(cv::Point(cvRound(expected.x * scale - radius), cvRound(expected.y * scale - radius)),
+                              cv::Point(cvRound(expected.x * scale + radius), cvRound(expected.y * scale + radius)));
+        return window & zoneRect;
+    }
 
-            ellipse(sheetMat, center, cv::Size2f(size.width * 0.5f, size.height * 0.5f), angle, 0, 360, targetColor, drawingWidth);
+    Result<Ellipse> tryGetTargetEllipseForZone(const SheetAnalysis &analysis, int zone, TargetDetectionMode mode,
+                                               TargetBuffers &buffers) {
+        SUBVISION_TRACE_SCOPE("getTargetEllipseForZone");
+        const cv::Rect zoneRect = getCropCoordinates(analysis.sheet.size(), zone);
+
+        // Fenêtre autour de la position attendue de la cible, agrandie tant que la détection échoue ou que
+        // l'ellipse touche un bord intérieur de la fenêtre, jusqu'à la zone entière
+        for (int growth = 0;; ++growth) {
+            const cv::Rect window = getTargetSearchWindow(analysis.sheet.size(), zone, growth);
+            Result<Ellipse> ellipse = detectTargetInWindow(analysis, window, zone, mode, buffers);
+            if (window == zoneRect) {
+                // Coordonnées de la zone, comme les autres fonctions de détection des cibles
+                return ellipse;
+            }
+            if (ellipse && isInsideSearchWindow(*ellipse, window, zoneRect)) {
+                return ellipse->translated(cv::Point2f(window.tl() - zoneRect.tl()));
+            }
+            SUBVISION_LOG_DEBUG("Target not found in search window " << window << " for zone " << zone);
+        }
+    }
 
-            const cv::Point centerMouche = tupleIntCast(std::get<0>(ellipseMouche));
-            const cv::Size2f sizeMouche = std::get<1>(ellipseMouche);
-            const float angleMouche = std::get<2>(ellipseMouche);
+    std::map<int, Ellipse> getTargetsEllipse(const cv::Mat &image) {
+        return getTargetsEllipse(analyzeSheet(image));
+    }
+
+    std::map<int, Ellipse> getTargetsEllipse(const cv::Mat &image, ThreadPool &pool) {
+        return getTargetsEllipse(analyzeSheet(image), pool);
+    }
+
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, TargetDetectionMode mode) {
+        std::array<TargetBuffers, 5> buffers;
+        std::map<int, Ellipse> ellipses;
+        const Status status = detectTargets(analysis, mode, buffers, ellipses);
+        if (!status) {
+            raiseError(status.error().message);
+        }
+        return ellipses;
+    }
 
-            ellipse(sheetMat, centerMouche, cv::Size2f(sizeMouche.width * 0.5f, sizeMouche.height * 0.5f), angleMouche, 0, 360, targetColor, drawingWidth);
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, ThreadPool &pool,
+                                             TargetDetectionMode mode) {
+        std::array<TargetBuffers, 5> buffers;
+        std::map<int, Ellipse> ellipses;
+        const Status status = detectTargets(analysis, pool, mode, buffers, ellipses);
+        if (!status) {
+            raiseError(status.error().message);
+        }
+        return ellipses;
+    }
 
-            const cv::Point centerPetitBlanc = tupleIntCast(std::get<0>(ellipsePetitBlanc));
-            const cv::Size2f sizePetitBlanc = std::get<1>(ellipsePetitBlanc);
-            const float anglePetitBlanc = std::get<2>(ellipsePetitBlanc);
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options) {
+        return options.threadPool
+                   ? getTargetsEllipse(analysis, *options.threadPool, options.targetDetectionMode)
+                   : getTargetsEllipse(analysis, options.targetDetectionMode);
+    }
 
-            ellipse(sheetMat, centerPetitBlanc, cv::Size2f(sizePetitBlanc.width * 0.5f, sizePetitBlanc.height * 0.5f), anglePetitBlanc, 0, 360, targetColor, drawingWidth);
+    std::map<int, Ellipse> getTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options,
+                                             ProcessingContext &context) {
+        return valueOrRaise(tryGetTargetsEllipse(analysis, options, context));
+    }
 
-            const cv::Point centerMoyenBlanc = tupleIntCast(std::get<0>(ellipseMoyenBlanc));
-            const cv::Size2f sizeMoyenBlanc = std::get<1>(ellipseMoyenBlanc);
-            const float angleMoyenBlanc = std::get<2>(ellipseMoyenBlanc);
+    Result<std::map<int, Ellipse>> tryGetTargetsEllipse(const SheetAnalysis &analysis,
+                                                        const ProcessingOptions &options,
+                                                        ProcessingContext &context) {
+        std::map<int, Ellipse> ellipses;
+        const Status status = tryGetTargetsEllipse(analysis, options, context, ellipses);
+        if (!status) {
+            return Unexpected(status.error());
+        }
+        return ellipses;
+    }
 
-            ellipse(sheetMat, centerMoyenBlanc, cv::Size2f(sizeMoyenBlanc.width * 0.5f, sizeMoyenBlanc.height * 0.5f), angleMoyenBlanc, 0, 360, targetColor, drawingWidth);
+    Status tryGetTargetsEllipse(const SheetAnalysis &analysis, const ProcessingOptions &options,
+                                ProcessingContext &context, std::map<int, Ellipse> &ellipses) {
+        return options.threadPool
+                   ? detectTargets(analysis, *options.threadPool, options.targetDetectionMode, context.targets,
+                                   ellipses)
+                   : detectTargets(analysis, options.targetDetectionMode, context.targets, ellipses);
+    }
 
-            const cv::Point centerGrandBlanc = tupleIntCast(std::get<0>(ellipseGrandBlanc));
-            const cv::Size2f sizeGrandBlanc = std::get<1>(ellipseGrandBlanc);
-            const float angleGrandBlanc = std::get<2>(ellipseGrandBlanc);
+    std::map<int, Ellipse> targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses) {
+        return targetCoordinatesToSheetCoordinates(
+            ellipses, cv::Size(PICTURE_WIDTH_SHEET_DETECTION, PICTURE_HEIGHT_SHEET_DETECTION));
+    }
 
-            ellipse(sheetMat, centerGrandBlanc, cv::Size2f(sizeGrandBlanc.width * 0.5f, sizeGrandBlanc.height * 0.5f), angleGrandBlanc, 0, 360, targetColor, drawingWidth);
+    std::map<int, Ellipse> targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses,
+                                                               const cv::Size &sheetSize) {
+        std::map<int, Ellipse> newEllipses;
+        targetCoordinatesToSheetCoordinates(ellipses, sheetSize, newEllipses);
+        return newEllipses;
+    }
 
-            const cv::Point2f topPoint = getPointOnEllipse(ellipseCrossTip, halfPi);
-            const cv::Point2f bottomPoint = getPointOnEllipse(ellipseCrossTip, pi + halfPi);
-            const cv::Point2f leftPoint = getPointOnEllipse(ellipseCrossTip, pi);
-            const cv::Point2f rightPoint = getPointOnEllipse(ellipseCrossTip, 0.0f);
+    void targetCoordinatesToSheetCoordinates(const std::map<int, Ellipse> &ellipses, const cv::Size &sheetSize,
+                                             std::map<int, Ellipse> &sheetEllipses) {
+        const auto isConverted = [&ellipses](const int key) {
+            return key >= 0 && key < static_cast<int>(TARGET_EXPECTED_CENTERS.size()) && ellipses.count(key) > 0;
+        };
+        // Les nœuds des zones déjà présentes sont réutilisés
+        for (auto it = sheetEllipses.begin(); it != sheetEllipses.end();) {
+            it = isConverted(it->first) ? std::next(it) : sheetEllipses.erase(it);
+        }
 
-            line(sheetMat, tupleIntCast(topPoint), tupleIntCast(bottomPoint), targetColor, drawingWidth);
-            line(sheetMat, tupleIntCast(leftPoint), tupleIntCast(rightPoint), targetColor, drawingWidth);
+        for (const auto &[key, value]: ellipses) {
+            if (isConverted(key)) {
+                sheetEllipses[key] = value.translated(cv::Point2f(getCropCoordinates(sheetSize, key).tl()));
+            }
         }
     }
 
+    void drawTargets(const std::map<int, Ellipse> &coordinates, cv::Mat &sheetMat) {
+        SUBVISION_TRACE_SCOPE("drawTargets");
+        std::vector<OverlayPrimitive> overlay;
+        appendTargetsOverlay(coordinates, overlay);
+        drawOverlay(overlay, sheetMat);
+    }
+
     void drawDetectedSheet(cv::Mat &sheetMat) {
     }
 }
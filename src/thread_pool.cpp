@@ -0,0 +1,59 @@
+#include "../include/thread_pool.h"
+
+#include <algorithm>
+
+namespace subvision {
+    ThreadPool::ThreadPool(std::size_t workerCount) {
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        workers.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::size() const {
+        return workers.size();
+    }
+
+    void ThreadPool::enqueue(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push(std::move(job));
+        }
+        condition.notify_one();
+    }
+
+    void ThreadPool::workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+                // Les tâches déjà soumises sont terminées avant l'arrêt
+                if (jobs.empty()) {
+                    return;
+                }
+
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            job();
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "../include/trace.h"
+
+#include <iostream>
+
+namespace subvision {
+    namespace {
+        std::mutex logMutex;
+        std::atomic<std::uint32_t> nextThreadId{1};
+        thread_local int currentDepth = 0;
+
+        // Identifiant court et stable du thread courant, plus lisible que std::thread::id dans les traces
+        std::uint32_t currentThreadId() {
+            thread_local const std::uint32_t threadId = nextThreadId++;
+            return threadId;
+        }
+
+        const char *levelName(const LogLevel level) {
+            switch (level) {
+                case LogLevel::Trace:
+                    return "TRACE";
+                case LogLevel::Debug:
+                    return "DEBUG";
+                case LogLevel::Info:
+                    return "INFO";
+                case LogLevel::Warning:
+                    return "WARNING";
+                case LogLevel::Error:
+                    return "ERROR";
+            }
+            return "";
+        }
+
+        void writeJsonString(std::ostream &out, const std::string &value) {
+            out << '"';
+            for (const char c: value) {
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    out << ' ';
+                } else {
+                    out << c;
+                }
+            }
+            out << '"';
+        }
+    }
+
+    void logMessage(const LogLevel level, const std::string &message) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::clog << "[subvision][" << levelName(level) << "] " << message << '\n';
+    }
+
+    Tracer::Tracer() : epoch(std::chrono::steady_clock::now()) {
+    }
+
+    Tracer &Tracer::instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void Tracer::setEnabled(const bool value) {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+
+    bool Tracer::isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void Tracer::record(TraceEvent event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        recordedEvents.push_back(std::move(event));
+    }
+
+    void Tracer::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        recordedEvents.clear();
+    }
+
+    std::vector<TraceEvent> Tracer::events() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return recordedEvents;
+    }
+
+    std::int64_t Tracer::nowMicros() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void Tracer::exportChromeTrace(std::ostream &out) const {
+        const std::vector<TraceEvent> snapshot = events();
+
+        out << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < snapshot.size(); ++i) {
+            const TraceEvent &event = snapshot[i];
+            if (i > 0) {
+                out << ',';
+            }
+            out << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":\"subvision\",\"ph\":\"X\",\"pid\":1"
+                    << ",\"tid\":" << event.threadId
+                    << ",\"ts\":" << event.startMicros
+                    << ",\"dur\":" << event.durationMicros
+                    << ",\"args\":{\"depth\":" << event.depth << "}}";
+        }
+        out << "],\"displayTimeUnit\":\"ms\"}";
+    }
+
+    void Tracer::exportJson(std::ostream &out) const {
+        const std::vector<TraceEvent> snapshot = events();
+
+        out << '[';
+        for (std::size_t i = 0; i < snapshot.size(); ++i) {
+            const TraceEvent &event = snapshot[i];
+            if (i > 0) {
+                out << ',';
+            }
+            out << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"threadId\":" << event.threadId
+                    << ",\"depth\":" << event.depth
+                    << ",\"startMicros\":" << event.startMicros
+                    << ",\"durationMicros\":" << event.durationMicros << '}';
+        }
+        out << ']';
+    }
+
+    TraceScope::TraceScope(const char *name) : name(name), active(Tracer::instance().isEnabled()) {
+        if (active) {
+            depth = currentDepth++;
+            startMicros = Tracer::instance().nowMicros();
+        }
+    }
+
+    TraceScope::~TraceScope() {
+        if (!active) {
+            return;
+        }
+
+        Tracer &tracer = Tracer::instance();
+        const std::int64_t endMicros = tracer.nowMicros();
+        --currentDepth;
+        tracer.record(TraceEvent{name, startMicros, endMicros - startMicros, currentThreadId(), depth});
+    }
+}
@@ -1,5 +1,6 @@
 #include "../include/utils.h"
 #include "../include/constants.h"
+#include "../include/scoring.h"
 
 namespace subvision {
 
@@ -35,19 +36,14 @@ namespace subvision {
     }
 
     cv::Point2f getPointOnEllipse(const Ellipse &ellipse, const float angle) {
-        const cv::Point2f &center = std::get<0>(ellipse);
-        const cv::Size2f &radii = std::get<1>(ellipse);
-        const float x = center.x + cos(angle) * (radii.width / 2);
-        const float y = center.y + sin(angle) * (radii.height / 2);
-        return {x, y};
+        const cv::Point2f &center = ellipse.center();
+        return {center.x + cos(angle) * ellipse.halfWidth(), center.y + sin(angle) * ellipse.halfHeight()};
     }
 
 
 
     Ellipse growEllipse(const Ellipse &ellipse, const float factor) {
-        const cv::Point2f &center = std::get<0>(ellipse);
-        const cv::Size2f &radii = std::get<1>(ellipse);
-        return std::make_tuple(center, cv::Size2f(radii.width * factor, radii.height * factor), std::get<2>(ellipse));
+        return ellipse.grown(factor);
     }
 
     float getDistance(const cv::Point2f &point1, const cv::Point2f &point2) {
@@ -70,26 +66,16 @@ namespace subvision {
     }
 
     int getScore(int distance) {
-        constexpr int maximumImpactDistance = 48;
-
-        if (distance > maximumImpactDistance) {
-            return 0;
-        }
-
-        if (distance <= 0) {
-            return 570;
-        }
-
-        if (distance <= 5) {
-            return 570 - (distance * 6);
-        }
-
-        return 570 - 30 - ((distance - 5) * 3);
+        return lookupScore(distance);
     }
 
     cv::Rect getCropCoordinates(const cv::Mat &image, int targetZone) {
-        int width = image.rows;
-        int height = image.cols;
+        return getCropCoordinates(image.size(), targetZone);
+    }
+
+    cv::Rect getCropCoordinates(const cv::Size &size, int targetZone) {
+        int width = size.height;
+        int height = size.width;
         int x1 = 0, x2 = width, y1 = 0, y2 = height;
 
         if (targetZone == SUBVISION_ZONE_BOTTOM_LEFT || targetZone == SUBVISION_ZONE_BOTTOM_RIGHT) {
@@ -119,6 +105,10 @@ namespace subvision {
         return sheetMat(coordinates).clone();
     }
 
+    cv::Mat getTargetView(const cv::Mat &sheetMat, const int targetZone) {
+        return sheetMat(getCropCoordinates(sheetMat, targetZone));
+    }
+
     std::vector<cv::Point2f> coordinatesToPercentage(const std::vector<cv::Point> &coordinates, const int width, const int height) {
         std::vector<cv::Point2f> percentageCoordinates;
         percentageCoordinates.reserve(coordinates.size());
@@ -132,7 +122,6 @@ namespace subvision {
                 static_cast<float>(coordinate.y) * invHeight
             );
         }
-        std::cout << "Converted " << percentageCoordinates.size() << " coordinates to percentage." << std::endl;
         return percentageCoordinates;
     }
 
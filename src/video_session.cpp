@@ -0,0 +1,150 @@
+#include "../include/video_session.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../include/constants.h"
+#include "../include/corner_tracking.h"
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/result.h"
+#include "../include/sheet_detection.h"
+#include "../include/target_detection.h"
+#include "../include/trace.h"
+#include "../include/utils.h"
+
+namespace subvision {
+    namespace {
+        // Variation d'aire tolérée entre la feuille suivie et la feuille détectée
+        constexpr double MIN_AREA_RATIO = 0.8;
+        constexpr double MAX_AREA_RATIO = 1.25;
+
+        float getMaxShift(const std::vector<cv::Point2f> &from, const std::vector<cv::Point2f> &to) {
+            float maxShift = 0;
+            for (std::size_t i = 0; i < from.size(); ++i) {
+                maxShift = std::max(maxShift, getDistance(from[i], to[i]));
+            }
+            return maxShift;
+        }
+    }
+
+    VideoSession::VideoSession(const VideoSessionOptions &options) : options(options) {
+    }
+
+    bool VideoSession::processFrame(const cv::Mat &frame, ImpactResults &results) {
+        SUBVISION_TRACE_SCOPE("VideoSession::processFrame");
+        if (frame.empty()) {
+            reset();
+            return false;
+        }
+
+        tracking = !sheetCorners.empty() && trackSheet(frame);
+        if (!tracking && !detectSheet(frame)) {
+            reset();
+            return false;
+        }
+
+        Status status = tryWarpSheet(frame, sheetCorners, context.sheet, options.processing.resolution);
+        if (!status) {
+            results.error = status.error();
+            reset();
+            return false;
+        }
+        const SheetAnalysis analysis = analyzeSheet(context.sheet, context);
+        status = updateSheetTargets(analysis);
+        if (!status) {
+            results.error = status.error();
+            return false;
+        }
+        return retrieveImpactsFromSheet(analysis, sheetTargets, results, options.processing);
+    }
+
+    void VideoSession::reset() {
+        sheetCorners.clear();
+        patches.clear();
+        detectedArea = 0;
+        score = 0;
+        tracking = false;
+        sheetTargets.clear();
+        targetCorners.clear();
+        targetsReused = false;
+    }
+
+    bool VideoSession::isTracking() const {
+        return tracking;
+    }
+
+    bool VideoSession::reusedTargets() const {
+        return targetsReused;
+    }
+
+    const std::vector<cv::Point2f> &VideoSession::corners() const {
+        return sheetCorners;
+    }
+
+    float VideoSession::trackingScore() const {
+        return score;
+    }
+
+    bool VideoSession::detectSheet(const cv::Mat &frame) {
+        SUBVISION_TRACE_SCOPE("VideoSession::detectSheet");
+        const Result<std::vector<cv::Point2f>> coordinates =
+                tryGetSheetCoordinates(frame, context, options.processing.sheetDetectionMode,
+                                       options.processing.resolution);
+        if (!coordinates) {
+            SUBVISION_LOG_DEBUG("Video frame without sheet: " << coordinates.error().message);
+            return false;
+        }
+        if (coordinates->size() != 4) {
+            return false;
+        }
+
+        sheetCorners = percentageToCoordinates(*coordinates, frame.cols, frame.rows);
+        detectedArea = cv::contourArea(sheetCorners);
+        score = 1.0f;
+        storeCornerPatches(frame, sheetCorners, options.patchRadius, patches);
+        // Nouvelle détection : les ellipses sont recalculées sur cette image
+        targetCorners.clear();
+        return true;
+    }
+
+    bool VideoSession::trackSheet(const cv::Mat &frame) {
+        SUBVISION_TRACE_SCOPE("VideoSession::trackSheet");
+        std::vector<cv::Point2f> tracked;
+        const float minScore = matchCornerPatches(frame, sheetCorners, patches, options.searchRadius, tracked);
+        if (minScore < 0) {
+            return false;
+        }
+
+        score = minScore;
+        if (minScore < options.minTrackingScore) {
+            SUBVISION_LOG_DEBUG("Sheet tracking lost, score " << minScore);
+            return false;
+        }
+
+        // La feuille suivie doit rester un quadrilatère convexe de taille comparable
+        const double areaRatio = cv::contourArea(tracked) / detectedArea;
+        if (!cv::isContourConvex(tracked) || areaRatio < MIN_AREA_RATIO || areaRatio > MAX_AREA_RATIO) {
+            SUBVISION_LOG_DEBUG("Sheet tracking rejected, area ratio " << areaRatio);
+            return false;
+        }
+
+        sheetCorners = std::move(tracked);
+        return true;
+    }
+
+    Status VideoSession::updateSheetTargets(const SheetAnalysis &analysis) {
+        targetsReused = !targetCorners.empty() &&
+                        getMaxShift(targetCorners, sheetCorners) <= options.targetReuseMaxShift;
+        if (!targetsReused) {
+            const Result<std::map<int, Ellipse>> targets = tryGetTargetsEllipse(analysis, options.processing, context);
+            if (!targets) {
+                targetCorners.clear();
+                return Unexpected(targets.error());
+            }
+            sheetTargets = targetCoordinatesToSheetCoordinates(*targets, analysis.sheet.size());
+            targetCorners = sheetCorners;
+        }
+        return {};
+    }
+}
@@ -0,0 +1,74 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::uint64_t> heapAllocationCount{0};
+    std::atomic<std::uint64_t> heapByteCount{0};
+    std::atomic<std::uint64_t> matAllocationCount{0};
+    std::atomic<std::uint64_t> matByteCount{0};
+
+    class CountingMatAllocator : public cv::MatAllocator {
+    public:
+        cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                               cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+            cv::UMatData *u = cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+            if (data == nullptr && u != nullptr) {
+                matAllocationCount.fetch_add(1, std::memory_order_relaxed);
+                matByteCount.fetch_add(u->size, std::memory_order_relaxed);
+            }
+            return u;
+        }
+
+        bool allocate(cv::UMatData *data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override {
+            return cv::Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+        }
+
+        void deallocate(cv::UMatData *data) const override {
+            cv::Mat::getStdAllocator()->deallocate(data);
+        }
+    };
+
+    CountingMatAllocator countingMatAllocator;
+}
+
+AllocationSnapshot AllocationSnapshot::now() {
+    AllocationSnapshot snapshot;
+    snapshot.heapAllocations = heapAllocationCount.load(std::memory_order_relaxed);
+    snapshot.heapBytes = heapByteCount.load(std::memory_order_relaxed);
+    snapshot.matAllocations = matAllocationCount.load(std::memory_order_relaxed);
+    snapshot.matBytes = matByteCount.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+AllocationSnapshot AllocationSnapshot::since(const AllocationSnapshot &start) const {
+    AllocationSnapshot delta;
+    delta.heapAllocations = heapAllocations - start.heapAllocations;
+    delta.heapBytes = heapBytes - start.heapBytes;
+    delta.matAllocations = matAllocations - start.matAllocations;
+    delta.matBytes = matBytes - start.matBytes;
+    return delta;
+}
+
+cv::MatAllocator *getCountingMatAllocator() {
+    return &countingMatAllocator;
+}
+
+void *operator new(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    heapByteCount.fetch_add(size, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
@@ -0,0 +1,24 @@
+#ifndef SUBVISION_CORE_ALLOCATION_COUNTER_H
+#define SUBVISION_CORE_ALLOCATION_COUNTER_H
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+
+// Compteurs d'allocations : tas C++ (operator new, remplacé dans AllocationCounter.cpp, à lier une seule fois
+// par exécutable) et buffers cv::Mat (allocateur à installer avec cv::Mat::setDefaultAllocator)
+struct AllocationSnapshot {
+    std::uint64_t heapAllocations = 0;
+    std::uint64_t heapBytes = 0;
+    std::uint64_t matAllocations = 0;
+    std::uint64_t matBytes = 0;
+
+    static AllocationSnapshot now();
+
+    // Allocations depuis start
+    AllocationSnapshot since(const AllocationSnapshot &start) const;
+};
+
+// Allocateur cv::Mat qui compte les buffers alloués par OpenCV (pas ceux fournis par l'appelant)
+cv::MatAllocator *getCountingMatAllocator();
+
+#endif //SUBVISION_CORE_ALLOCATION_COUNTER_H
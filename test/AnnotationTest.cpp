@@ -0,0 +1,147 @@
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/annotation.h"
+#include "../include/constants.h"
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/target_detection.h"
+#include "TestHelpers.h"
+
+namespace fs = std::filesystem;
+
+class AnnotationTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    static subvision::SheetAnalysis analyze(const cv::Mat& sheet) {
+        return subvision::analyzeSheet(sheet.clone());
+    }
+
+    static subvision::ProcessingOptions withMode(const subvision::AnnotationMode mode) {
+        subvision::ProcessingOptions options;
+        options.annotationMode = mode;
+        return options;
+    }
+
+    static double maxDifference(const cv::Mat& a, const cv::Mat& b) {
+        return cv::norm(a, b, cv::NORM_INF);
+    }
+
+    void runAnnotationTest(const std::string& folder) {
+        cv::Mat sheet = cv::imread(TESTS_RESOURCES_PATH + "/" + folder + "/cropped_sheet.jpg");
+        ASSERT_FALSE(sheet.empty());
+        cv::resize(sheet, sheet, cv::Size(subvision::PICTURE_WIDTH_SHEET_DETECTION,
+                                          subvision::PICTURE_HEIGHT_SHEET_DETECTION));
+
+        const subvision::SheetAnalysis reference = analyze(sheet);
+        const std::map<int, subvision::Ellipse> targets = subvision::targetCoordinatesToSheetCoordinates(
+            subvision::getTargetsEllipse(reference));
+        std::vector<cv::Point2f> impacts;
+        subvision::getImpactsCenters(reference.impacts, impacts);
+
+        // Dessin direct historique
+        cv::Mat expectedImage = sheet.clone();
+        subvision::drawTargets(targets, expectedImage);
+        const std::vector<subvision::Impact> expectedImpacts = subvision::drawAndGetImpactsPoints(
+            impacts, expectedImage, targets);
+
+        // Raster : même image et mêmes scores
+        subvision::ImpactResults raster;
+        subvision::fillImpactResults(analyze(sheet), targets, impacts, withMode(subvision::AnnotationMode::RASTER),
+                                     raster);
+        EXPECT_EQ(maxDifference(raster.annotatedImage, expectedImage), 0);
+        EXPECT_TRUE(raster.overlay.empty());
+        EXPECT_EQ(raster.targets.size(), targets.size());
+        expectSameImpacts(raster.impacts, expectedImpacts);
+
+        // Vectoriel : la feuille n'est pas modifiée, les primitives redonnent l'image raster
+        subvision::ImpactResults vectorResults;
+        subvision::fillImpactResults(analyze(sheet), targets, impacts, withMode(subvision::AnnotationMode::VECTOR),
+                                     vectorResults);
+        EXPECT_EQ(maxDifference(vectorResults.annotatedImage, sheet), 0);
+        ASSERT_FALSE(vectorResults.overlay.empty());
+        cv::Mat rendered = vectorResults.annotatedImage.clone();
+        subvision::drawOverlay(vectorResults.overlay, rendered);
+        EXPECT_EQ(maxDifference(rendered, expectedImage), 0);
+        expectSameImpacts(vectorResults.impacts, expectedImpacts);
+
+        // Sans annotation : scores uniquement
+        subvision::ImpactResults none;
+        subvision::fillImpactResults(analyze(sheet), targets, impacts, withMode(subvision::AnnotationMode::NONE),
+                                     none);
+        EXPECT_TRUE(none.annotatedImage.empty());
+        EXPECT_TRUE(none.overlay.empty());
+        EXPECT_EQ(none.targets.size(), targets.size());
+        expectSameImpacts(none.impacts, expectedImpacts);
+    }
+};
+
+TEST_F(AnnotationTests, TestAnnotationModes) {
+    int pictureCount = 0;
+    for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+        if (!entry.is_directory() || !fs::exists(entry.path() / "cropped_sheet.jpg")) {
+            continue;
+        }
+        const std::string folder = entry.path().filename().string();
+        SCOPED_TRACE("Testing folder: " + folder);
+        runAnnotationTest(folder);
+        pictureCount++;
+    }
+    ASSERT_GT(pictureCount, 0);
+}
+
+TEST_F(AnnotationTests, TestEncodedImage) {
+    cv::Mat sheet = cv::imread(TESTS_RESOURCES_PATH + "/1/cropped_sheet.jpg");
+    ASSERT_FALSE(sheet.empty());
+    cv::resize(sheet, sheet, cv::Size(subvision::PICTURE_WIDTH_SHEET_DETECTION,
+                                      subvision::PICTURE_HEIGHT_SHEET_DETECTION));
+    const subvision::SheetAnalysis reference = analyze(sheet);
+    const std::map<int, subvision::Ellipse> targets = subvision::targetCoordinatesToSheetCoordinates(
+        subvision::getTargetsEllipse(reference));
+    std::vector<cv::Point2f> impacts;
+    subvision::getImpactsCenters(reference.impacts, impacts);
+
+    subvision::ImpactResults raw;
+    subvision::fillImpactResults(analyze(sheet), targets, impacts,
+                                 withMode(subvision::AnnotationMode::RASTER), raw);
+    cv::Mat expected;
+    cv::resize(raw.annotatedImage, expected, cv::Size(800, 800), 0, 0, cv::INTER_AREA);
+
+    // JPEG réduit : l'image brute n'est plus retournée
+    subvision::ProcessingOptions jpegOptions = withMode(subvision::AnnotationMode::RASTER);
+    jpegOptions.encoding.format = subvision::ImageEncoding::JPEG;
+    jpegOptions.encoding.maxDimension = 800;
+    jpegOptions.encoding.quality = 85;
+    subvision::ImpactResults jpeg;
+    subvision::fillImpactResults(analyze(sheet), targets, impacts, jpegOptions, jpeg);
+    EXPECT_TRUE(jpeg.annotatedImage.empty());
+    ASSERT_FALSE(jpeg.encodedImage.empty());
+    EXPECT_LT(jpeg.encodedImage.size(), 1000000u);
+    const cv::Mat decodedJpeg = cv::imdecode(jpeg.encodedImage, cv::IMREAD_COLOR);
+    ASSERT_EQ(decodedJpeg.size(), cv::Size(800, 800));
+    EXPECT_GT(cv::PSNR(decodedJpeg, expected), 30.0);
+    expectSameImpacts(jpeg.impacts, raw.impacts);
+
+    // PNG sans perte, image brute conservée à la demande
+    subvision::ProcessingOptions pngOptions = jpegOptions;
+    pngOptions.encoding.format = subvision::ImageEncoding::PNG;
+    pngOptions.encoding.keepImage = true;
+    subvision::ImpactResults png;
+    subvision::fillImpactResults(analyze(sheet), targets, impacts, pngOptions, png);
+    EXPECT_FALSE(png.annotatedImage.empty());
+    const cv::Mat decodedPng = cv::imdecode(png.encodedImage, cv::IMREAD_COLOR);
+    EXPECT_EQ(maxDifference(decodedPng, expected), 0);
+
+    // Sans annotation, il n'y a rien à encoder
+    subvision::ProcessingOptions noneOptions = jpegOptions;
+    noneOptions.annotationMode = subvision::AnnotationMode::NONE;
+    subvision::ImpactResults none;
+    subvision::fillImpactResults(analyze(sheet), targets, impacts, noneOptions, none);
+    EXPECT_TRUE(none.encodedImage.empty());
+}
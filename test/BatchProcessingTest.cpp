@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/batch_processing.h"
+#include "../include/impact_detection.h"
+#include "TestHelpers.h"
+
+namespace fs = std::filesystem;
+
+class BatchProcessingTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    std::vector<std::string> getImagePaths() {
+        std::vector<std::string> paths;
+        for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+            const fs::path imagePath = entry.path() / "image.jpg";
+            if (entry.is_directory() && fs::exists(imagePath)) {
+                paths.push_back(imagePath.string());
+            }
+        }
+        return paths;
+    }
+
+    static bool retrieveSingleImpacts(const cv::Mat& image, subvision::ImpactResults& results) {
+        try {
+            return subvision::retrieveImpacts(image, results);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+};
+
+TEST_F(BatchProcessingTests, TestBatchMatchesSingleImageProcessing) {
+    std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    // Une entrée vide ne doit pas interrompre le batch
+    frames.insert(frames.begin() + 1, cv::Mat());
+
+    subvision::BatchOptions options;
+    options.workerCount = 6;
+    options.queueCapacity = 2;
+    const std::vector<subvision::BatchItemResult> results = subvision::retrieveImpactsBatch(frames, options);
+
+    ASSERT_EQ(results.size(), frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        SCOPED_TRACE("Testing frame: " + std::to_string(i));
+        ASSERT_EQ(results[i].index, i);
+
+        if (i == 1) {
+            ASSERT_FALSE(results[i].success);
+            ASSERT_FALSE(results[i].error.empty());
+            continue;
+        }
+
+        ASSERT_TRUE(results[i].success) << results[i].error;
+        subvision::ImpactResults expected;
+        ASSERT_TRUE(subvision::retrieveImpacts(frames[i], expected));
+        expectSameScores(results[i].results, expected);
+    }
+    std::cout << "Batch Processing: Tested " << frames.size() << " pictures" << std::endl;
+}
+
+TEST_F(BatchProcessingTests, TestBatchWithFewWorkers) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    // Étapes regroupées : tout sur le thread appelant, puis un lecteur et un ou deux workers
+    for (const std::size_t workerCount : {1u, 2u, 3u}) {
+        SCOPED_TRACE("Testing worker count: " + std::to_string(workerCount));
+        subvision::BatchOptions options;
+        options.workerCount = workerCount;
+        const std::vector<subvision::BatchItemResult> results = subvision::retrieveImpactsBatch(frames, options);
+
+        ASSERT_EQ(results.size(), frames.size());
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            ASSERT_EQ(results[i].index, i);
+            ASSERT_TRUE(results[i].success) << results[i].error;
+            subvision::ImpactResults expected;
+            ASSERT_TRUE(subvision::retrieveImpacts(frames[i], expected));
+            expectSameScores(results[i].results, expected);
+        }
+    }
+}
+
+TEST_F(BatchProcessingTests, TestDefaultBatchSharesCoresWithOpenCV) {
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const int openCVThreads = cv::getNumThreads();
+
+    // Par défaut : workers et threads internes d'OpenCV se partagent les coeurs
+    const subvision::BatchThreads threads = subvision::getBatchThreads();
+    EXPECT_GE(threads.workerCount, 1u);
+    EXPECT_GE(threads.openCVThreads, 1);
+    EXPECT_LE(threads.workerCount * static_cast<std::size_t>(threads.openCVThreads), cores);
+
+    // Sans réglage global : le nombre de threads d'OpenCV est conservé, le nombre de workers s'adapte
+    subvision::BatchOptions options;
+    options.limitOpenCVThreads = false;
+    const subvision::BatchThreads shared = subvision::getBatchThreads(options);
+    EXPECT_EQ(shared.openCVThreads, std::max(1, openCVThreads));
+    EXPECT_LE(shared.workerCount * static_cast<std::size_t>(shared.openCVThreads),
+              std::max(cores, static_cast<std::size_t>(shared.openCVThreads)));
+
+    // Le réglage global est rétabli à la fin du batch
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+    subvision::retrieveImpactsBatch(std::vector<cv::Mat>{frames.front()});
+    EXPECT_EQ(cv::getNumThreads(), openCVThreads);
+}
+
+TEST_F(BatchProcessingTests, TestBatchReadsImageFiles) {
+    std::vector<std::string> paths = getImagePaths();
+    ASSERT_FALSE(paths.empty()) << "No image.jpg found in " << TESTS_RESOURCES_PATH;
+    paths.push_back(TESTS_RESOURCES_PATH + "/missing/image.jpg");
+
+    const std::vector<subvision::BatchItemResult> results = subvision::retrieveImpactsBatch(paths);
+
+    ASSERT_EQ(results.size(), paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        SCOPED_TRACE("Testing path: " + paths[i]);
+        ASSERT_EQ(results[i].index, i);
+        ASSERT_EQ(results[i].source, paths[i]);
+
+        // Le batch échoue exactement quand le traitement d'une image seule échoue
+        subvision::ImpactResults expected;
+        const cv::Mat image = cv::imread(paths[i]);
+        const bool expectedSuccess = !image.empty() && retrieveSingleImpacts(image, expected);
+        ASSERT_EQ(results[i].success, expectedSuccess) << results[i].error;
+        if (expectedSuccess) {
+            expectSameScores(results[i].results, expected);
+        } else {
+            ASSERT_FALSE(results[i].error.empty());
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/color_kernels.h"
+
+class ColorKernelsTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Toutes les combinaisons BGR, plus une vue non continue de largeur impaire
+        image.create(4096, 4096, CV_8UC3);
+        for (int i = 0; i < 256 * 256 * 256; ++i) {
+            image.at<cv::Vec3b>(i / 4096, i % 4096) = cv::Vec3b(static_cast<uchar>(i >> 16),
+                                                                 static_cast<uchar>(i >> 8),
+                                                                 static_cast<uchar>(i));
+        }
+        view = image(cv::Rect(3, 5, 1001, 777));
+    }
+
+    void TearDown() override {}
+
+    static cv::Mat getChannel(const cv::Mat& bgr, const int code, const int channel) {
+        cv::Mat converted;
+        cv::cvtColor(bgr, converted, code);
+        cv::Mat result;
+        cv::extractChannel(converted, result, channel);
+        return result;
+    }
+
+    static void expectSameChannel(const cv::Mat& actual, const cv::Mat& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        ASSERT_EQ(actual.type(), CV_8UC1);
+        ASSERT_EQ(cv::norm(actual, expected, cv::NORM_INF), 0);
+    }
+
+    static void expectSameRange(const cv::Mat& channel, const double minVal, const double maxVal) {
+        double expectedMin, expectedMax;
+        cv::minMaxLoc(channel, &expectedMin, &expectedMax);
+        ASSERT_EQ(minVal, expectedMin);
+        ASSERT_EQ(maxVal, expectedMax);
+    }
+
+    cv::Mat image;
+    cv::Mat view;
+};
+
+TEST_F(ColorKernelsTests, TestSaturationMatchesCvtColor) {
+    for (const cv::Mat& input : {image, view}) {
+        cv::Mat saturation;
+        double minVal, maxVal;
+        subvision::extractSaturation(input, saturation, &minVal, &maxVal);
+        expectSameChannel(saturation, getChannel(input, cv::COLOR_BGR2HSV, 1));
+        expectSameRange(saturation, minVal, maxVal);
+    }
+}
+
+TEST_F(ColorKernelsTests, TestLightnessMatchesCvtColor) {
+    for (const cv::Mat& input : {image, view}) {
+        cv::Mat lightness;
+        double minVal, maxVal;
+        subvision::extractLightness(input, lightness, &minVal, &maxVal);
+        expectSameChannel(lightness, getChannel(input, cv::COLOR_BGR2HLS, 1));
+        expectSameRange(lightness, minVal, maxVal);
+    }
+}
+
+TEST_F(ColorKernelsTests, TestInvertedZMatchesCvtColor) {
+    for (const cv::Mat& input : {image, view}) {
+        cv::Mat invertedZ;
+        double minVal, maxVal;
+        subvision::extractInvertedZ(input, invertedZ, &minVal, &maxVal);
+        cv::Mat expected = getChannel(input, cv::COLOR_BGR2XYZ, 2);
+        cv::bitwise_not(expected, expected);
+        expectSameChannel(invertedZ, expected);
+        expectSameRange(invertedZ, minVal, maxVal);
+    }
+}
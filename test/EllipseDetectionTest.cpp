@@ -6,33 +6,36 @@
 #include <gtest/gtest.h>
 #include "../include/constants.h"
 #include "../include/image_processing.h"
+#include "../include/impact_detection.h"
 #include "../include/target_detection.h"
+#include "../include/thread_pool.h"
+#include "../include/utils.h"
+#include "TestHelpers.h"
 
 namespace fs = std::filesystem;
 
-const std::string TESTS_RESOURCES_PATH = (fs::current_path() / "resources").string();
-
 class EllipseDetectionTests : public ::testing::Test {
 protected:
     void SetUp() override {}
 
     void TearDown() override {}
 
-    void runEllipsesTest(const std::string& folder) {
+    void runEllipsesTest(const std::string& folder,
+                         subvision::TargetDetectionMode mode = subvision::TargetDetectionMode::FULL_RESOLUTION) {
         std::string imgPath = TESTS_RESOURCES_PATH + "/" + folder + "/cropped_sheet.jpg";
         std::string expectedMaskPath = TESTS_RESOURCES_PATH + "/" + folder + "/expected_visuals.jpg";
 
         cv::Mat img = cv::imread(imgPath);
         cv::resize(img,img, cv::Size(subvision::PICTURE_WIDTH_SHEET_DETECTION, subvision::PICTURE_HEIGHT_SHEET_DETECTION));
-        std::map<int, subvision::Ellipse> ellipses = subvision::getTargetsEllipse(img);
+        std::map<int, subvision::Ellipse> ellipses = subvision::getTargetsEllipse(subvision::analyzeSheet(img), mode);
         std::map<int, subvision::Ellipse> targetsEllipsis = subvision::targetCoordinatesToSheetCoordinates(ellipses);
 
         cv::Mat blackMat = cv::Mat::zeros(subvision::PICTURE_HEIGHT_SHEET_DETECTION, subvision::PICTURE_WIDTH_SHEET_DETECTION, CV_8UC1);
         for (const auto& pair : targetsEllipsis) {
             const auto& value = pair.second;
-            cv::Point center = cv::Point(static_cast<int>(std::get<0>(value).x), static_cast<int>(std::get<0>(value).y));
-            cv::Size size = cv::Size(static_cast<int>(std::get<1>(value).width), static_cast<int>(std::get<1>(value).height));
-            float angle = std::get<2>(value);
+            cv::Point center = cv::Point(static_cast<int>(value.center().x), static_cast<int>(value.center().y));
+            cv::Size size = cv::Size(static_cast<int>(value.axes().width), static_cast<int>(value.axes().height));
+            float angle = value.angle();
             cv::ellipse(blackMat, center, cv::Size(size.width/2, size.height/2), angle, 0, 360, 255, -1);
         }
 
@@ -47,6 +50,32 @@ protected:
 
         ASSERT_GE(similarity, 0.995) << "Ellipses detection failed for folder " << folder << ", similarity: " << similarity;
     }
+
+    // Masque des cibles en coordonnées feuille (2000x2000)
+    static cv::Mat drawTargetsMask(const std::map<int, subvision::Ellipse>& targets) {
+        cv::Mat mask = cv::Mat::zeros(subvision::PICTURE_HEIGHT_SHEET_DETECTION,
+                                      subvision::PICTURE_WIDTH_SHEET_DETECTION, CV_8UC1);
+        for (const auto& [zone, ellipse] : targets) {
+            const cv::Point center(static_cast<int>(ellipse.center().x), static_cast<int>(ellipse.center().y));
+            const cv::Size axes(static_cast<int>(ellipse.axes().width) / 2, static_cast<int>(ellipse.axes().height) / 2);
+            cv::ellipse(mask, center, axes, ellipse.angle(), 0, 360, 255, -1);
+        }
+        return mask;
+    }
+
+    void runParallelEllipsesTest(const std::string& folder, subvision::ThreadPool& pool) {
+        std::string imgPath = TESTS_RESOURCES_PATH + "/" + folder + "/cropped_sheet.jpg";
+
+        cv::Mat img = cv::imread(imgPath);
+        cv::resize(img,img, cv::Size(subvision::PICTURE_WIDTH_SHEET_DETECTION, subvision::PICTURE_HEIGHT_SHEET_DETECTION));
+        std::map<int, subvision::Ellipse> sequential = subvision::getTargetsEllipse(img);
+        std::map<int, subvision::Ellipse> parallel = subvision::getTargetsEllipse(img, pool);
+
+        ASSERT_EQ(sequential.size(), parallel.size()) << "Parallel ellipses detection failed for folder " << folder;
+        for (const auto& [zone, ellipse] : sequential) {
+            ASSERT_TRUE(parallel.at(zone) == ellipse) << "Parallel ellipse differs for folder " << folder << ", zone: " << zone;
+        }
+    }
 };
 
 TEST_F(EllipseDetectionTests, TestEllipsesDetection) {
@@ -70,3 +99,102 @@ TEST_F(EllipseDetectionTests, TestEllipsesDetection) {
     }
     std::cout << "Ellipse Detection: Tested " << pictureCount << " pictures" << std::endl;
 }
+
+TEST_F(EllipseDetectionTests, TestParallelEllipsesDetection) {
+    subvision::ThreadPool pool(4);
+
+    int pictureCount = 0;
+    for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+        if (entry.is_directory()) {
+            std::string folder = entry.path().filename().string();
+            if (folder != "TODO" && folder.find("WIP") == std::string::npos) {
+                SCOPED_TRACE("Testing folder: " + folder);
+                runParallelEllipsesTest(folder, pool);
+                pictureCount++;
+            }
+        }
+    }
+    std::cout << "Parallel Ellipse Detection: Tested " << pictureCount << " pictures" << std::endl;
+}
+
+TEST_F(EllipseDetectionTests, TestPyramidEllipsesDetection) {
+    int pictureCount = 0;
+    for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+        if (entry.is_directory()) {
+            std::string folder = entry.path().filename().string();
+            if (folder != "TODO" && folder.find("WIP") == std::string::npos) {
+                SCOPED_TRACE("Testing folder: " + folder);
+                runEllipsesTest(folder, subvision::TargetDetectionMode::PYRAMID);
+                pictureCount++;
+            }
+        }
+    }
+    std::cout << "Pyramid Ellipse Detection: Tested " << pictureCount << " pictures" << std::endl;
+}
+
+TEST_F(EllipseDetectionTests, TestPyramidFromSourceImageMatchesFullResolution) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    subvision::ProcessingOptions fullOptions;
+    fullOptions.targetDetectionMode = subvision::TargetDetectionMode::FULL_RESOLUTION;
+    subvision::ProcessingOptions pyramidOptions;
+    pyramidOptions.targetDetectionMode = subvision::TargetDetectionMode::PYRAMID;
+
+    // Image BGR complète : le niveau grossier de la pyramide est redressé directement depuis la photo
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        SCOPED_TRACE("Testing frame: " + std::to_string(i));
+        subvision::ImpactResults full;
+        subvision::ImpactResults pyramid;
+        ASSERT_TRUE(subvision::retrieveImpacts(frames[i], full, fullOptions));
+        ASSERT_TRUE(subvision::retrieveImpacts(frames[i], pyramid, pyramidOptions));
+        ASSERT_EQ(pyramid.targets.size(), full.targets.size());
+
+        cv::Mat xorMat;
+        cv::bitwise_xor(drawTargetsMask(pyramid.targets), drawTargetsMask(full.targets), xorMat);
+        const double similarity = 1.0 - static_cast<double>(cv::countNonZero(xorMat)) / xorMat.total();
+        ASSERT_GE(similarity, 0.995) << "Pyramid targets differ from full resolution, similarity: " << similarity;
+    }
+}
+
+TEST_F(EllipseDetectionTests, TestTargetSearchWindows) {
+    const cv::Size sheetSize(subvision::PICTURE_WIDTH_SHEET_DETECTION, subvision::PICTURE_HEIGHT_SHEET_DETECTION);
+    for (const int zone : subvision::TARGET_ZONES) {
+        const cv::Rect zoneRect = subvision::getCropCoordinates(sheetSize, zone);
+        const cv::Rect window = subvision::getTargetSearchWindow(sheetSize, zone, 0);
+        EXPECT_EQ(window & zoneRect, window) << "zone: " << zone;
+        EXPECT_LT(window.area() * 2, zoneRect.area()) << "zone: " << zone;
+
+        // Agrandie après chaque échec jusqu'à la zone entière
+        int growth = 0;
+        while (subvision::getTargetSearchWindow(sheetSize, zone, growth) != zoneRect && growth < 10) {
+            ++growth;
+        }
+        EXPECT_LT(growth, 10) << "zone: " << zone;
+    }
+
+    int pictureCount = 0;
+    for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+        if (entry.is_directory()) {
+            std::string folder = entry.path().filename().string();
+            if (folder != "TODO" && folder.find("WIP") == std::string::npos) {
+                SCOPED_TRACE("Testing folder: " + folder);
+                cv::Mat img = cv::imread(TESTS_RESOURCES_PATH + "/" + folder + "/cropped_sheet.jpg");
+                cv::resize(img, img, sheetSize);
+                const subvision::SheetAnalysis analysis = subvision::analyzeSheet(img);
+
+                // Même ellipse dans la fenêtre de recherche que sur la zone entière
+                for (const int zone : subvision::TARGET_ZONES) {
+                    const subvision::Ellipse windowed = subvision::getTargetEllipseForZone(analysis, zone);
+                    const subvision::Ellipse full = subvision::getTargetEllipse(
+                        subvision::getTargetView(analysis.sheet, zone), subvision::getTargetView(analysis.impactsMask, zone));
+                    EXPECT_LE(cv::norm(windowed.center() - full.center()), 2.0) << "zone: " << zone;
+                    EXPECT_NEAR(windowed.axes().width, full.axes().width, 2.0f) << "zone: " << zone;
+                    EXPECT_NEAR(windowed.axes().height, full.axes().height, 2.0f) << "zone: " << zone;
+                }
+                pictureCount++;
+            }
+        }
+    }
+    std::cout << "Target search windows: Tested " << pictureCount << " pictures" << std::endl;
+}
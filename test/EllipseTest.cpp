@@ -0,0 +1,63 @@
+#include <array>
+#include <cmath>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/constants.h"
+#include "../include/ellipse.h"
+#include "../include/utils.h"
+
+class EllipseTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+};
+
+TEST_F(EllipseTests, TestPointAtFollowsRotation) {
+    const subvision::Ellipse ellipse(cv::Point2f(400.5f, 300.25f), cv::Size2f(240, 160), 35.0f);
+
+    // Mêmes points que cv::ellipse2Poly (degré par degré, demi-axes, orientation en degrés)
+    std::vector<cv::Point2d> expected;
+    cv::ellipse2Poly(cv::Point2d(ellipse.center()), cv::Size2d(120, 80), 35, 0, 360, 1, expected);
+    for (int degree = 0; degree < 360; ++degree) {
+        const cv::Point2f point = ellipse.pointAt(subvision::toRadians(static_cast<float>(degree)));
+        EXPECT_NEAR(point.x, expected[degree].x, 1e-3) << "degree: " << degree;
+        EXPECT_NEAR(point.y, expected[degree].y, 1e-3) << "degree: " << degree;
+        EXPECT_NEAR(ellipse.radialDistance(point), 1.0f, 1e-5f) << "degree: " << degree;
+    }
+    EXPECT_FLOAT_EQ(ellipse.radialDistance(ellipse.center()), 0.0f);
+}
+
+TEST_F(EllipseTests, TestGrownAndTranslated) {
+    const subvision::Ellipse ellipse(cv::Point2f(100, 200), cv::Size2f(90, 110), 10.0f);
+    const subvision::Ellipse grown = ellipse.grown(1.8f);
+    EXPECT_EQ(grown.center(), ellipse.center());
+    EXPECT_FLOAT_EQ(grown.axes().width, 162.0f);
+    EXPECT_FLOAT_EQ(grown.halfHeight(), 99.0f);
+    EXPECT_EQ(grown.angle(), ellipse.angle());
+    EXPECT_NEAR(grown.radialDistance(ellipse.pointAt(0.7f)), 1.0f / 1.8f, 1e-5f);
+    EXPECT_TRUE(subvision::growEllipse(ellipse, 1.8f) == grown);
+
+    const subvision::Ellipse moved = ellipse.translated(cv::Point2f(1000, 0));
+    EXPECT_EQ(moved.center(), cv::Point2f(1100, 200));
+    EXPECT_NEAR(moved.radialDistance(ellipse.pointAt(2.0f) + cv::Point2f(1000, 0)), 1.0f, 1e-5f);
+
+    // Point sans orientation utilisé pour les scores : inchangé
+    const cv::Point2f legacy = subvision::getPointOnEllipse(grown, 0.5f);
+    EXPECT_FLOAT_EQ(legacy.x, 100.0f + std::cos(0.5f) * 81.0f);
+    EXPECT_FLOAT_EQ(legacy.y, 200.0f + std::sin(0.5f) * 99.0f);
+}
+
+TEST_F(EllipseTests, TestRingClassification) {
+    const subvision::Ellipse ellipse(cv::Point2f(500, 500), cv::Size2f(200, 180), 60.0f);
+    const std::array<float, 4> &rings = subvision::TARGET_RING_FACTORS;
+
+    EXPECT_EQ(ellipse.ring(ellipse.center(), rings), 0u);
+    for (std::size_t i = 0; i < rings.size(); ++i) {
+        // Juste à l'intérieur puis juste à l'extérieur de chaque anneau
+        EXPECT_EQ(ellipse.ring(ellipse.grown(rings[i] * 0.99f).pointAt(1.2f), rings), i) << "ring: " << i;
+        EXPECT_EQ(ellipse.ring(ellipse.grown(rings[i] * 1.01f).pointAt(1.2f), rings), i + 1) << "ring: " << i;
+    }
+    EXPECT_TRUE(subvision::Ellipse().empty());
+}
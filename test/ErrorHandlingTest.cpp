@@ -0,0 +1,95 @@
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/impact_detection.h"
+#include "../include/result.h"
+#include "../include/sheet_detection.h"
+#include "TestHelpers.h"
+
+class ErrorHandlingTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+};
+
+TEST_F(ErrorHandlingTests, TestInvalidImage) {
+    subvision::ProcessingContext context;
+
+    const auto empty = subvision::tryGetSheetCoordinates(cv::Mat(), context);
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().code, subvision::ErrorCode::INVALID_IMAGE);
+
+    const auto gray = subvision::tryGetSheetCoordinates(cv::Mat(100, 100, CV_8UC1, cv::Scalar(0)), context);
+    ASSERT_FALSE(gray.has_value());
+    EXPECT_EQ(gray.error().code, subvision::ErrorCode::INVALID_IMAGE);
+
+    subvision::ImageBuffer buffer;
+    buffer.format = subvision::PixelFormat::NV12;
+    buffer.width = 64;
+    buffer.height = 64;
+    const auto missingPlanes = subvision::tryGetSheetCoordinates(buffer, context);
+    ASSERT_FALSE(missingPlanes.has_value());
+    EXPECT_EQ(missingPlanes.error().code, subvision::ErrorCode::INVALID_IMAGE);
+}
+
+TEST_F(ErrorHandlingTests, TestNoSheet) {
+    const cv::Mat black(600, 800, CV_8UC3, cv::Scalar(0, 0, 0));
+    subvision::ProcessingContext context;
+    subvision::ImpactResults results;
+
+    const subvision::Status status = subvision::tryRetrieveImpacts(black, results, subvision::ProcessingOptions(),
+                                                                   context);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().code, subvision::ErrorCode::NO_SHEET);
+    EXPECT_EQ(status.error().zone, -1);
+    EXPECT_EQ(results.error.code, subvision::ErrorCode::NO_SHEET);
+    EXPECT_TRUE(results.impacts.empty());
+
+    // Les API historiques lèvent toujours une exception avec le même message
+    subvision::ImpactResults legacy;
+    EXPECT_THROW(subvision::retrieveImpacts(black, legacy), std::runtime_error);
+}
+
+TEST_F(ErrorHandlingTests, TestDegenerateHomography) {
+    const std::vector<cv::Point2f> collinear = {{0, 0}, {100, 100}, {200, 200}, {300, 300}};
+    const auto transform = subvision::tryGetSheetTransform(collinear);
+    ASSERT_FALSE(transform.has_value());
+    EXPECT_EQ(transform.error().code, subvision::ErrorCode::DEGENERATE_HOMOGRAPHY);
+
+    const std::vector<cv::Point2f> missing = {{0, 0}, {100, 0}, {100, 100}};
+    EXPECT_FALSE(subvision::tryGetSheetTransform(missing).has_value());
+
+    cv::Mat sheet;
+    const subvision::Status status = subvision::tryWarpSheet(cv::Mat(400, 400, CV_8UC3), collinear, sheet);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().code, subvision::ErrorCode::DEGENERATE_HOMOGRAPHY);
+}
+
+TEST_F(ErrorHandlingTests, TestSuccessClearsError) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+    const cv::Mat& frame = frames.front();
+
+    subvision::ProcessingContext context;
+    subvision::ImpactResults results;
+    const subvision::ProcessingOptions options;
+    ASSERT_FALSE(subvision::tryRetrieveImpacts(cv::Mat(), results, options, context).has_value());
+    EXPECT_EQ(results.error.code, subvision::ErrorCode::INVALID_IMAGE);
+
+    // Même résultat que l'API historique, l'erreur précédente est effacée
+    ASSERT_TRUE(subvision::tryRetrieveImpacts(frame, results, options, context).has_value());
+    EXPECT_EQ(results.error.code, subvision::ErrorCode::NONE);
+    EXPECT_TRUE(results.error.message.empty());
+
+    subvision::ImpactResults expected;
+    ASSERT_TRUE(subvision::retrieveImpacts(frame, expected, options));
+    ASSERT_EQ(results.impacts.size(), expected.impacts.size());
+    for (std::size_t i = 0; i < expected.impacts.size(); ++i) {
+        EXPECT_EQ(results.impacts[i].score, expected.impacts[i].score);
+        EXPECT_EQ(results.impacts[i].zone, expected.impacts[i].zone);
+    }
+}
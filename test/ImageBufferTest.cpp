@@ -0,0 +1,172 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/image_buffer.h"
+#include "../include/impact_detection.h"
+#include "../include/sheet_detection.h"
+#include "../include/utils.h"
+#include "TestHelpers.h"
+
+class ImageBufferTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // Conversion en YUV 4:2:0 contigu dans le format demandé
+    static cv::Mat toYuv(const cv::Mat& bgr, const subvision::PixelFormat format) {
+        cv::Mat i420;
+        cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+        if (format == subvision::PixelFormat::I420) {
+            return i420;
+        }
+
+        const int width = bgr.cols;
+        const int height = bgr.rows;
+        const size_t lumaSize = static_cast<size_t>(width) * height;
+        const cv::Mat u(height / 2, width / 2, CV_8UC1, i420.data + lumaSize);
+        const cv::Mat v(height / 2, width / 2, CV_8UC1, i420.data + lumaSize + lumaSize / 4);
+
+        cv::Mat semiPlanar(height * 3 / 2, width, CV_8UC1);
+        i420.rowRange(0, height).copyTo(semiPlanar.rowRange(0, height));
+        cv::Mat chroma(height / 2, width / 2, CV_8UC2, semiPlanar.ptr(height));
+        const std::vector<cv::Mat> planes = format == subvision::PixelFormat::NV12
+                                                ? std::vector<cv::Mat>{u, v}
+                                                : std::vector<cv::Mat>{v, u};
+        cv::merge(planes, chroma);
+        return semiPlanar;
+    }
+};
+
+TEST_F(ImageBufferTests, TestRgbaMatchesBgr) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const cv::Mat& frame : frames) {
+        cv::Mat rgba;
+        cv::cvtColor(frame, rgba, cv::COLOR_BGR2RGBA);
+        const subvision::ImageBuffer image = subvision::makePackedImageBuffer(
+            subvision::PixelFormat::RGBA, rgba.cols, rgba.rows, rgba.data, rgba.step);
+
+        ASSERT_EQ(subvision::getSheetCoordinates(image), subvision::getSheetCoordinates(frame));
+        ASSERT_EQ(cv::norm(subvision::getSheetPicture(image), subvision::getSheetPicture(frame), cv::NORM_INF), 0);
+
+        subvision::ImpactResults actual, expected;
+        ASSERT_TRUE(subvision::retrieveImpacts(image, actual));
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, expected));
+        ASSERT_EQ(actual.impacts.size(), expected.impacts.size());
+        for (std::size_t i = 0; i < expected.impacts.size(); ++i) {
+            ASSERT_EQ(actual.impacts[i].score, expected.impacts[i].score);
+            ASSERT_EQ(actual.impacts[i].zone, expected.impacts[i].zone);
+        }
+    }
+}
+
+TEST_F(ImageBufferTests, TestYuvSheetMatchesConvertedImage) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const auto format : {subvision::PixelFormat::NV12, subvision::PixelFormat::NV21,
+                              subvision::PixelFormat::I420}) {
+        SCOPED_TRACE("Testing format: " + std::to_string(static_cast<int>(format)));
+        for (const cv::Mat& frame : frames) {
+            const cv::Mat yuv = toYuv(frame, format);
+            const subvision::ImageBuffer image = subvision::makeContiguousYuvImageBuffer(
+                format, frame.cols, frame.rows, yuv.data);
+
+            // Détection sur le plan Y : mêmes coins qu'avec la luminosité HLS, à un pixel de détection près
+            const cv::Mat converted = subvision::toBgr(image);
+            const std::vector<cv::Point2f> expectedCorners = subvision::getSheetCoordinates(converted);
+            const std::vector<cv::Point2f> corners = subvision::getSheetCoordinates(image);
+            ASSERT_EQ(corners.size(), expectedCorners.size());
+            for (std::size_t i = 0; i < corners.size(); ++i) {
+                ASSERT_LT(cv::norm(corners[i] - expectedCorners[i]), 0.002);
+            }
+
+            // Redressement plan par plan : proche de la conversion complète suivie du redressement
+            const cv::Mat expectedSheet = subvision::warpSheet(
+                converted, subvision::percentageToCoordinates(corners, frame.cols, frame.rows));
+            cv::Mat difference;
+            cv::absdiff(subvision::getSheetPicture(image), expectedSheet, difference);
+            ASSERT_LT(cv::mean(difference)[0], 4.0);
+
+            subvision::ImpactResults results;
+            ASSERT_TRUE(subvision::retrieveImpacts(image, results));
+        }
+    }
+}
+
+TEST_F(ImageBufferTests, TestTooSmallStrideIsRejected) {
+    const int width = 64;
+    const int height = 48;
+    const std::vector<uchar> pixels(static_cast<size_t>(width) * height * 4, 0);
+
+    // Pas inférieur à une ligne de pixels : INVALID_IMAGE, sans assertion d'OpenCV à la création des vues
+    const auto rgba = subvision::tryMakePackedImageBuffer(subvision::PixelFormat::RGBA, width, height,
+                                                          pixels.data(), width * 4 - 1);
+    ASSERT_FALSE(rgba.has_value());
+    EXPECT_EQ(rgba.error().code, subvision::ErrorCode::INVALID_IMAGE);
+    EXPECT_FALSE(subvision::tryMakePackedImageBuffer(subvision::PixelFormat::BGR, width, height, pixels.data(),
+                                                     width * 3 - 3).has_value());
+    EXPECT_TRUE(subvision::tryMakePackedImageBuffer(subvision::PixelFormat::BGR, width, height, pixels.data(),
+                                                    width * 3).has_value());
+
+    subvision::ImageBuffer nv12;
+    nv12.format = subvision::PixelFormat::NV12;
+    nv12.width = width;
+    nv12.height = height;
+    nv12.planes[0] = pixels.data();
+    nv12.planes[1] = pixels.data() + width * height;
+    nv12.strides[0] = width;
+    nv12.strides[1] = width - 2;
+    EXPECT_FALSE(subvision::validateImageBuffer(nv12).has_value());
+    nv12.strides[1] = width;
+    EXPECT_TRUE(subvision::validateImageBuffer(nv12).has_value());
+    nv12.strides[0] = width - 1;
+    EXPECT_FALSE(subvision::validateImageBuffer(nv12).has_value());
+
+    subvision::ImageBuffer i420;
+    i420.format = subvision::PixelFormat::I420;
+    i420.width = width;
+    i420.height = height;
+    i420.planes[0] = pixels.data();
+    i420.planes[1] = pixels.data() + width * height;
+    i420.planes[2] = pixels.data() + width * height * 5 / 4;
+    i420.strides[0] = width;
+    i420.strides[1] = width / 2;
+    i420.strides[2] = width / 2 - 1;
+    EXPECT_FALSE(subvision::validateImageBuffer(i420).has_value());
+
+    // Détection de la feuille : l'erreur est retournée au lieu d'être levée par getPlaneView
+    subvision::ProcessingContext context;
+    const auto corners = subvision::tryGetSheetCoordinates(i420, context);
+    ASSERT_FALSE(corners.has_value());
+    EXPECT_EQ(corners.error().code, subvision::ErrorCode::INVALID_IMAGE);
+}
+
+TEST_F(ImageBufferTests, TestPlanarBufferWithStrides) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const cv::Mat& frame = frames.front();
+    const cv::Mat i420 = toYuv(frame, subvision::PixelFormat::I420);
+    const int width = frame.cols;
+    const int height = frame.rows;
+    const size_t lumaSize = static_cast<size_t>(width) * height;
+
+    // Plans copiés dans des buffers plus larges que l'image (pas supérieur à la largeur)
+    cv::Mat y(height, width + 64, CV_8UC1, cv::Scalar(0));
+    cv::Mat u(height / 2, width / 2 + 32, CV_8UC1, cv::Scalar(0));
+    cv::Mat v(height / 2, width / 2 + 32, CV_8UC1, cv::Scalar(0));
+    i420.rowRange(0, height).copyTo(y.colRange(0, width));
+    cv::Mat(height / 2, width / 2, CV_8UC1, i420.data + lumaSize).copyTo(u.colRange(0, width / 2));
+    cv::Mat(height / 2, width / 2, CV_8UC1, i420.data + lumaSize + lumaSize / 4).copyTo(v.colRange(0, width / 2));
+
+    const subvision::ImageBuffer image = subvision::makePlanarImageBuffer(width, height, y.data, y.step, u.data,
+                                                                          u.step, v.data, v.step);
+    cv::Mat expected;
+    cv::cvtColor(i420, expected, cv::COLOR_YUV2BGR_I420);
+    ASSERT_EQ(cv::norm(subvision::toBgr(image), expected, cv::NORM_INF), 0);
+}
@@ -88,3 +88,36 @@ TEST_F(ImpactDetectionTests, TestImpactsDetection) {
     }
     std::cout << "Impact Detection: Tested " << pictureCount << " pictures" << std::endl;
 }
+
+TEST_F(ImpactDetectionTests, TestExtractImpactsShape) {
+    cv::Mat mask = cv::Mat::zeros(300, 400, CV_8UC1);
+    cv::ellipse(mask, cv::Point(120, 100), cv::Size(40, 20), 30, 0, 360, cv::Scalar(255), -1);
+    cv::ellipse(mask, cv::Point(300, 200), cv::Size(12, 12), 0, 0, 360, cv::Scalar(255), -1);
+    // Rectangle plein et pixel isolé : ignorés
+    cv::rectangle(mask, cv::Point(20, 250), cv::Point(60, 270), cv::Scalar(255), -1);
+    mask.at<uchar>(10, 390) = 255;
+
+    cv::Mat ellipseMask;
+    const std::vector<subvision::ImpactBlob> impacts = subvision::extractImpacts(mask, &ellipseMask);
+    ASSERT_EQ(impacts.size(), 2u);
+
+    const subvision::ImpactBlob& elongated = impacts[0];
+    EXPECT_NEAR(elongated.center.x, 120, 0.25);
+    EXPECT_NEAR(elongated.center.y, 100, 0.25);
+    EXPECT_NEAR(elongated.axes.width, 80, 1.5);
+    EXPECT_NEAR(elongated.axes.height, 40, 1.5);
+    EXPECT_NEAR(elongated.angle, 30, 1.0);
+    EXPECT_EQ(elongated.area, cv::countNonZero(mask(cv::Rect(0, 0, 200, 200))));
+
+    const subvision::ImpactBlob& round = impacts[1];
+    EXPECT_NEAR(round.center.x, 300, 0.25);
+    EXPECT_NEAR(round.center.y, 200, 0.25);
+    EXPECT_NEAR(round.axes.width, round.axes.height, 0.5);
+
+    // Le masque des ellipses recouvre les impacts, sans le rectangle ni le pixel isolé
+    EXPECT_EQ(ellipseMask.at<uchar>(100, 120), 255);
+    EXPECT_EQ(ellipseMask.at<uchar>(200, 300), 255);
+    EXPECT_EQ(ellipseMask.at<uchar>(260, 40), 0);
+    EXPECT_EQ(ellipseMask.at<uchar>(10, 390), 0);
+    EXPECT_EQ(subvision::getImpactsCoordinatesFromMask(mask).size(), impacts.size());
+}
@@ -0,0 +1,59 @@
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/morphology.h"
+
+class MorphologyTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Masque binaire aléatoire, plus une vue non continue et des images plus petites que la fenêtre
+        cv::RNG rng(12345);
+        cv::Mat noise(601, 733, CV_8UC1);
+        rng.fill(noise, cv::RNG::UNIFORM, 0, 256);
+        cv::threshold(noise, mask, 100, 255, cv::THRESH_BINARY);
+        images = {mask, mask(cv::Rect(7, 3, 301, 257)), mask(cv::Rect(0, 0, 5, 3)), mask(cv::Rect(10, 10, 1, 1))};
+    }
+
+    void TearDown() override {}
+
+    static void expectSameMask(const cv::Mat& actual, const cv::Mat& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        ASSERT_EQ(actual.type(), CV_8UC1);
+        ASSERT_EQ(cv::norm(actual, expected, cv::NORM_INF), 0);
+    }
+
+    cv::Mat mask;
+    std::vector<cv::Mat> images;
+};
+
+TEST_F(MorphologyTests, TestMatchesRepeatedDefaultElement) {
+    subvision::MorphologyBuffers buffers;
+    for (const cv::Mat& image : images) {
+        for (const int radius : {0, 1, 2, 3, 10, 20, 40}) {
+            SCOPED_TRACE(cv::format("%dx%d radius %d", image.cols, image.rows, radius));
+            cv::Mat expected, actual;
+
+            cv::erode(image, expected, cv::Mat(), cv::Point(-1, -1), radius);
+            subvision::erodeRect(image, actual, radius, buffers);
+            expectSameMask(actual, expected);
+
+            cv::dilate(image, expected, cv::Mat(), cv::Point(-1, -1), radius);
+            subvision::dilateRect(image, actual, radius, buffers);
+            expectSameMask(actual, expected);
+        }
+    }
+}
+
+TEST_F(MorphologyTests, TestInPlaceOpenClose) {
+    subvision::MorphologyBuffers buffers;
+    for (const int radius : {2, 3, 10}) {
+        cv::Mat expected;
+        cv::erode(mask, expected, cv::Mat(), cv::Point(-1, -1), radius);
+        cv::dilate(expected, expected, cv::Mat(), cv::Point(-1, -1), radius * 2);
+        cv::erode(expected, expected, cv::Mat(), cv::Point(-1, -1), radius);
+
+        cv::Mat actual = mask.clone();
+        subvision::openCloseRect(actual, actual, radius, buffers);
+        expectSameMask(actual, expected);
+    }
+}
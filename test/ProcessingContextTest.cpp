@@ -0,0 +1,139 @@
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/impact_detection.h"
+#include "../include/processing_context.h"
+#include "../include/target_detection.h"
+#include "AllocationCounter.h"
+#include "TestHelpers.h"
+
+class ProcessingContextTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Buffers cv::Mat comptés pendant le test
+        previousAllocator = cv::Mat::getDefaultAllocator();
+        cv::Mat::setDefaultAllocator(getCountingMatAllocator());
+    }
+
+    void TearDown() override {
+        cv::Mat::setDefaultAllocator(previousAllocator);
+    }
+
+    cv::MatAllocator* previousAllocator = nullptr;
+};
+
+TEST_F(ProcessingContextTests, TestContextMatchesPlainProcessing) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const subvision::ProcessingOptions options;
+    subvision::ProcessingContext context;
+    context.reserve();
+    const uchar* sheetData = context.sheet.data;
+    const uchar* maskData = context.impactsMask.data;
+
+    // Deux passes : la seconde réutilise des buffers déjà remplis par d'autres images
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const cv::Mat& frame : frames) {
+            subvision::ImpactResults expected;
+            ASSERT_TRUE(subvision::retrieveImpacts(frame, expected, options));
+
+            subvision::ImpactResults results;
+            ASSERT_TRUE(subvision::retrieveImpacts(frame, results, options, context));
+            expectSameResults(results, expected);
+
+            // Les images du contexte ne sont pas réallouées
+            EXPECT_EQ(context.sheet.data, sheetData);
+            EXPECT_EQ(context.impactsMask.data, maskData);
+            EXPECT_EQ(results.annotatedImage.data, sheetData);
+        }
+    }
+}
+
+TEST_F(ProcessingContextTests, TestDetachedResultsAreKept) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const subvision::ProcessingOptions options;
+    subvision::ProcessingContext context;
+
+    subvision::ImpactResults first;
+    ASSERT_TRUE(subvision::retrieveImpacts(frames.front(), first, options, context));
+    const cv::Mat firstImage = first.annotatedImage.clone();
+    context.detachResults();
+
+    // L'appel suivant écrit dans une nouvelle feuille, l'image précédente est intacte
+    subvision::ImpactResults second;
+    ASSERT_TRUE(subvision::retrieveImpacts(frames.back(), second, options, context));
+    EXPECT_NE(second.annotatedImage.data, first.annotatedImage.data);
+    EXPECT_EQ(cv::norm(first.annotatedImage, firstImage, cv::NORM_INF), 0);
+}
+
+TEST_F(ProcessingContextTests, TestSecondPassReusesResultContainers) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const subvision::AnnotationMode mode : {subvision::AnnotationMode::VECTOR, subvision::AnnotationMode::NONE}) {
+        subvision::ProcessingOptions options;
+        options.annotationMode = mode;
+        subvision::ProcessingContext context;
+        subvision::ImpactResults results;
+
+        for (const cv::Mat& frame : frames) {
+            ASSERT_TRUE(subvision::retrieveImpacts(frame, results, options, context));
+            const subvision::ImpactResults expected = results;
+            subvision::SheetAnalysis analysis;
+            analysis.sheet = context.sheet;
+            analysis.impactsMask = context.impactsMask;
+
+            // Seconde passe sur les mêmes cibles et impacts : conversion des cibles et remplissage des
+            // résultats sans aucune allocation
+            const AllocationSnapshot start = AllocationSnapshot::now();
+            subvision::targetCoordinatesToSheetCoordinates(context.targetsEllipsis, context.sheet.size(),
+                                                           context.sheetTargetsEllipsis);
+            const subvision::Status status = subvision::tryFillImpactResults(
+                analysis, context.sheetTargetsEllipsis, context.impactsCoordinates, options, results);
+            const AllocationSnapshot allocations = AllocationSnapshot::now().since(start);
+
+            ASSERT_TRUE(status.has_value());
+            EXPECT_EQ(allocations.heapAllocations, 0u);
+            EXPECT_EQ(allocations.matAllocations, 0u);
+            expectSameResults(results, expected);
+            EXPECT_EQ(results.overlay.size(), expected.overlay.size());
+        }
+    }
+}
+
+TEST_F(ProcessingContextTests, TestSecondPassDoesNotAllocateContextImages) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const subvision::ProcessingOptions options;
+    subvision::ProcessingContext context;
+    subvision::ImpactResults results;
+    for (const cv::Mat& frame : frames) {
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, results, options, context));
+    }
+
+    for (const cv::Mat& frame : frames) {
+        AllocationSnapshot start = AllocationSnapshot::now();
+        subvision::ImpactResults plainResults;
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, plainResults, options));
+        const AllocationSnapshot plain = AllocationSnapshot::now().since(start);
+
+        start = AllocationSnapshot::now();
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, results, options, context));
+        const AllocationSnapshot reused = AllocationSnapshot::now().since(start);
+
+        // Les allocations restantes sont internes à OpenCV : au moins la feuille et le masque des impacts
+        // ne sont plus alloués
+        const std::uint64_t contextImageBytes = context.sheet.total() * context.sheet.elemSize() +
+                                                context.impactsMask.total() * context.impactsMask.elemSize();
+        EXPECT_LT(reused.matAllocations, plain.matAllocations);
+        EXPECT_LE(reused.matBytes + contextImageBytes, plain.matBytes);
+        EXPECT_LT(reused.heapAllocations, plain.heapAllocations);
+    }
+}
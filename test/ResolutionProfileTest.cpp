@@ -0,0 +1,131 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/constants.h"
+#include "../include/image_processing.h"
+#include "../include/impact_detection.h"
+#include "../include/resolution_profile.h"
+#include "../include/target_detection.h"
+#include "TestHelpers.h"
+
+namespace fs = std::filesystem;
+
+// Profils calculés à la compilation
+static_assert(subvision::FAST_PROFILE.sheetSize == 800 && subvision::FAST_PROFILE.impactMorphologyRadius == 1 &&
+              subvision::FAST_PROFILE.targetCloseIterations == 4 && subvision::FAST_PROFILE.pyramidFactor == 2 &&
+              subvision::FAST_PROFILE.targetSearchRadius == 120);
+static_assert(subvision::BALANCED_PROFILE.sheetSize == 1200 &&
+              subvision::BALANCED_PROFILE.targetCloseIterations == 6 &&
+              subvision::BALANCED_PROFILE.targetSearchRadius == 180);
+static_assert(subvision::PRECISE_PROFILE.sheetSize == subvision::PICTURE_WIDTH_SHEET_DETECTION);
+
+class ResolutionProfileTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    std::vector<std::string> getFolders() {
+        std::vector<std::string> folders;
+        for (const auto& entry : fs::directory_iterator(TESTS_RESOURCES_PATH)) {
+            const std::string folder = entry.path().filename().string();
+            if (entry.is_directory() && folder != "TODO" && folder.find("WIP") == std::string::npos &&
+                fs::exists(entry.path() / "cropped_sheet.jpg")) {
+                folders.push_back(folder);
+            }
+        }
+        return folders;
+    }
+
+    // Cibles détectées sur une feuille au côté du profil, ramenées sur la feuille de référence et comparées
+    // au masque attendu
+    void runProfileEllipsesTest(const std::string& folder, const subvision::ResolutionProfile resolution) {
+        const subvision::ProcessingProfile& profile = subvision::getProcessingProfile(resolution);
+        const cv::Size sheetSize(profile.sheetSize, profile.sheetSize);
+        const cv::Size referenceSize(subvision::PICTURE_WIDTH_SHEET_DETECTION,
+                                     subvision::PICTURE_HEIGHT_SHEET_DETECTION);
+
+        cv::Mat img = cv::imread(TESTS_RESOURCES_PATH + "/" + folder + "/cropped_sheet.jpg");
+        cv::resize(img, img, sheetSize);
+        const std::map<int, subvision::Ellipse> ellipses = subvision::targetCoordinatesToSheetCoordinates(
+            subvision::getTargetsEllipse(subvision::analyzeSheet(img)), sheetSize);
+        ASSERT_EQ(ellipses.size(), 5u) << "Missing targets for folder " << folder;
+
+        const float factor = 1.0f / profile.scale;
+        cv::Mat mask = cv::Mat::zeros(referenceSize, CV_8UC1);
+        for (const auto& [zone, ellipse] : ellipses) {
+            // Centres des pixels alignés comme avec resize
+            const cv::Point center(static_cast<int>((ellipse.center().x + 0.5f) * factor - 0.5f),
+                                   static_cast<int>((ellipse.center().y + 0.5f) * factor - 0.5f));
+            const cv::Size axes(static_cast<int>(ellipse.axes().width * factor) / 2,
+                                static_cast<int>(ellipse.axes().height * factor) / 2);
+            cv::ellipse(mask, center, axes, ellipse.angle(), 0, 360, 255, -1);
+        }
+
+        cv::Mat expectedMask = cv::imread(TESTS_RESOURCES_PATH + "/" + folder + "/expected_visuals.jpg",
+                                          cv::IMREAD_GRAYSCALE);
+        cv::resize(expectedMask, expectedMask, referenceSize);
+        cv::threshold(expectedMask, expectedMask, 127, 255, cv::THRESH_BINARY);
+
+        cv::Mat xorMat;
+        cv::bitwise_xor(mask, expectedMask, xorMat);
+        const double similarity = 1.0 - static_cast<double>(cv::countNonZero(xorMat)) / xorMat.total();
+        ASSERT_GE(similarity, 0.995) << "Ellipses detection failed for folder " << folder << ", similarity: "
+                                     << similarity;
+    }
+};
+
+TEST_F(ResolutionProfileTests, TestProfileLookup) {
+    EXPECT_EQ(subvision::getProcessingProfile(subvision::ResolutionProfile::FAST).sheetSize, 800);
+    EXPECT_EQ(subvision::getProcessingProfile(subvision::ResolutionProfile::BALANCED).sheetSize, 1200);
+    EXPECT_EQ(subvision::getProcessingProfile(subvision::ResolutionProfile::PRECISE).sheetSize, 2000);
+    EXPECT_EQ(subvision::getProcessingProfile(1200).targetCloseIterations,
+              subvision::BALANCED_PROFILE.targetCloseIterations);
+    // Côté quelconque : paramètres mis à l'échelle, au moins 1
+    EXPECT_EQ(subvision::getProcessingProfile(100).impactMorphologyRadius, 1);
+    EXPECT_EQ(subvision::getProcessingProfile(1000).targetSearchRadius, 150);
+}
+
+TEST_F(ResolutionProfileTests, TestReducedProfilesEllipsesDetection) {
+    const std::vector<std::string> folders = getFolders();
+    ASSERT_FALSE(folders.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const auto resolution : {subvision::ResolutionProfile::FAST, subvision::ResolutionProfile::BALANCED}) {
+        for (const std::string& folder : folders) {
+            SCOPED_TRACE("Testing folder: " + folder);
+            runProfileEllipsesTest(folder, resolution);
+        }
+    }
+}
+
+TEST_F(ResolutionProfileTests, TestReducedProfilePipeline) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const auto resolution : {subvision::ResolutionProfile::FAST, subvision::ResolutionProfile::BALANCED}) {
+        const int side = subvision::getProcessingProfile(resolution).sheetSize;
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            SCOPED_TRACE("Testing frame: " + std::to_string(i));
+            const cv::Mat& frame = frames[i];
+
+            subvision::ProcessingOptions options;
+            options.resolution = resolution;
+            subvision::ImpactResults results;
+            ASSERT_TRUE(subvision::retrieveImpacts(frame, results, options));
+            EXPECT_EQ(results.annotatedImage.size(), cv::Size(side, side));
+            ASSERT_EQ(results.targets.size(), 5u);
+            // Cibles et impacts en coordonnées de la feuille du profil
+            for (const auto& [zone, ellipse] : results.targets) {
+                EXPECT_GE(ellipse.center().x, 0.0f);
+                EXPECT_LT(ellipse.center().x, static_cast<float>(side));
+                EXPECT_LT(ellipse.center().y, static_cast<float>(side));
+            }
+            for (const auto& impact : results.impacts) {
+                EXPECT_GE(impact.score, 0);
+                EXPECT_LE(impact.score, 570);
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/impact_detection.h"
+#include "../include/rig_calibration.h"
+#include "TestHelpers.h"
+
+class RigCalibrationTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+};
+
+TEST_F(RigCalibrationTests, TestCachedGeometryMatchesFullDetection) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const cv::Mat& frame : frames) {
+        subvision::RigCalibration rig;
+        ASSERT_TRUE(rig.calibrate(frame).has_value());
+        ASSERT_TRUE(rig.isCalibrated());
+        ASSERT_EQ(rig.corners().size(), 4u);
+        ASSERT_EQ(rig.targets().size(), 5u);
+
+        subvision::ImpactResults cached;
+        ASSERT_TRUE(rig.processImage(frame, cached));
+        ASSERT_TRUE(rig.usedCalibration());
+        EXPECT_GE(rig.verificationScore(), 0.8f);
+        EXPECT_EQ(cached.error.code, subvision::ErrorCode::NONE);
+
+        // Tables de remap en virgule fixe : mêmes impacts que le redressement par warpPerspective,
+        // à l'arrondi près de quelques pixels interpolés
+        subvision::ImpactResults expected;
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, expected));
+        ASSERT_EQ(cached.impacts.size(), expected.impacts.size());
+        for (std::size_t i = 0; i < expected.impacts.size(); ++i) {
+            EXPECT_EQ(cached.impacts[i].zone, expected.impacts[i].zone);
+            EXPECT_LE(std::abs(cached.impacts[i].score - expected.impacts[i].score), 3);
+        }
+    }
+}
+
+TEST_F(RigCalibrationTests, TestMovedSheetFallsBackToDetection) {
+    const std::vector<cv::Mat> frames = getFrames();
+    const std::vector<cv::Mat> moved = getFrames(1.0, cv::Point(30, -20));
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    subvision::RigCalibration rig;
+    ASSERT_TRUE(rig.calibrate(frames.front()).has_value());
+    const std::vector<cv::Point2f> calibratedCorners = rig.corners();
+
+    // Coins déplacés : la géométrie enregistrée est rejetée et le poste est recalibré sur l'image
+    subvision::ImpactResults results;
+    ASSERT_TRUE(rig.processImage(moved.front(), results));
+    EXPECT_FALSE(rig.usedCalibration());
+    ASSERT_EQ(rig.corners().size(), calibratedCorners.size());
+    for (std::size_t i = 0; i < calibratedCorners.size(); ++i) {
+        EXPECT_NEAR(rig.corners()[i].x - calibratedCorners[i].x, 30.0f, 2.0f);
+        EXPECT_NEAR(rig.corners()[i].y - calibratedCorners[i].y, -20.0f, 2.0f);
+    }
+
+    ASSERT_TRUE(rig.processImage(moved.front(), results));
+    EXPECT_TRUE(rig.usedCalibration());
+}
+
+TEST_F(RigCalibrationTests, TestFailedDetectionKeepsCalibration) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    subvision::RigCalibration rig;
+    ASSERT_TRUE(rig.calibrate(frames.front()).has_value());
+
+    // Support vide : pas de feuille, le calibrage reste utilisable pour l'image suivante
+    const cv::Mat empty(frames.front().size(), CV_8UC3, cv::Scalar(40, 40, 40));
+    subvision::ImpactResults results;
+    ASSERT_FALSE(rig.processImage(empty, results));
+    EXPECT_FALSE(rig.usedCalibration());
+    EXPECT_EQ(results.error.code, subvision::ErrorCode::NO_SHEET);
+    EXPECT_TRUE(rig.isCalibrated());
+
+    ASSERT_TRUE(rig.processImage(frames.front(), results));
+    EXPECT_TRUE(rig.usedCalibration());
+    EXPECT_EQ(results.error.code, subvision::ErrorCode::NONE);
+}
@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/constants.h"
+#include "../include/impact_detection.h"
+#include "../include/scoring.h"
+#include "../include/utils.h"
+
+class ScoringTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // Cibles d'une feuille 2000x2000, légèrement elliptiques
+    std::map<int, subvision::Ellipse> getTargets() {
+        return {
+            {subvision::SUBVISION_ZONE_TOP_LEFT, {cv::Point2f(480.3f, 500.7f), cv::Size2f(330, 335), 12.0f}},
+            {subvision::SUBVISION_ZONE_TOP_RIGHT, {cv::Point2f(1500.9f, 500.2f), cv::Size2f(340, 332), 95.0f}},
+            {subvision::SUBVISION_ZONE_BOTTOM_LEFT, {cv::Point2f(475.2f, 1525.8f), cv::Size2f(331, 338), 0.0f}},
+            {subvision::SUBVISION_ZONE_BOTTOM_RIGHT, {cv::Point2f(1495.6f, 1525.4f), cv::Size2f(334, 333), 45.0f}},
+            {subvision::SUBVISION_ZONE_CENTER, {cv::Point2f(990.5f, 1010.1f), cv::Size2f(336, 336), 0.0f}}
+        };
+    }
+};
+
+TEST_F(ScoringTests, TestScoreTableMatchesRules) {
+    static_assert(subvision::SCORE_TABLE[0] == 570);
+    static_assert(subvision::SCORE_TABLE[subvision::MAXIMUM_IMPACT_DISTANCE + 1] == 0);
+
+    for (int distance = -5; distance <= subvision::MAXIMUM_IMPACT_DISTANCE + 10; ++distance) {
+        int expected = 0;
+        if (distance <= 0) {
+            expected = 570;
+        } else if (distance <= 5) {
+            expected = 570 - distance * 6;
+        } else if (distance <= subvision::MAXIMUM_IMPACT_DISTANCE) {
+            expected = 540 - (distance - 5) * 3;
+        }
+        EXPECT_EQ(subvision::lookupScore(distance), expected) << "distance: " << distance;
+        EXPECT_EQ(subvision::getScore(distance), expected) << "distance: " << distance;
+    }
+}
+
+TEST_F(ScoringTests, TestBatchMatchesScoreImpacts) {
+    const std::map<int, subvision::Ellipse> targets = getTargets();
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, 2000.0f);
+    std::vector<cv::Point2f> impacts;
+    std::vector<float> x, y;
+    for (int i = 0; i < 20000; ++i) {
+        impacts.emplace_back(coordinate(generator), coordinate(generator));
+    }
+    // Centres exacts et tronqués des cibles
+    for (const auto &[zone, ellipse] : targets) {
+        impacts.push_back(ellipse.center());
+        impacts.push_back(subvision::tupleIntCast(ellipse.center()));
+    }
+    for (const cv::Point2f &impact : impacts) {
+        x.push_back(impact.x);
+        y.push_back(impact.y);
+    }
+
+    const std::vector<subvision::Impact> expected = subvision::scoreImpacts(impacts, targets);
+    subvision::ScoreBatch batch;
+    subvision::scoreImpactBatch(x, y, subvision::getTargetBatch(targets), batch);
+    ASSERT_EQ(batch.size(), expected.size());
+
+    // Distance sans trigonométrie : seuls quelques arrondis à 0.5 mm près peuvent différer d'un point
+    int roundingDifferences = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(batch.zones[i], expected[i].zone) << "impact: " << i;
+        ASSERT_LE(std::abs(batch.distances[i] - expected[i].distance), 1) << "impact: " << i;
+        ASSERT_EQ(batch.scores[i], subvision::getScore(batch.distances[i])) << "impact: " << i;
+        EXPECT_FLOAT_EQ(batch.angles[i], expected[i].angle) << "impact: " << i;
+        if (batch.distances[i] != expected[i].distance) {
+            ++roundingDifferences;
+        }
+    }
+    EXPECT_LE(roundingDifferences, static_cast<int>(expected.size() / 1000));
+}
+
+TEST_F(ScoringTests, TestBatchWithoutTargets) {
+    const std::vector<float> x = {10.0f, 1500.0f};
+    const std::vector<float> y = {20.0f, 800.0f};
+    subvision::ScoreBatch batch;
+    subvision::scoreImpactBatch(x, y, subvision::TargetBatch(), batch);
+
+    ASSERT_EQ(batch.size(), 2u);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(batch.zones[i], subvision::SUBVISION_ZONE_UNDEFINED);
+        EXPECT_EQ(batch.scores[i], 0);
+    }
+}
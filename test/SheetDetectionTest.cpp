@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/constants.h"
+#include "../include/image_buffer.h"
+#include "../include/sheet_detection.h"
+#include "../include/utils.h"
+#include "TestHelpers.h"
+
+class SheetDetectionTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // Chaque coin attendu a un coin détecté à moins de tolerance pixels (l'ordre des coins peut différer)
+    static void expectSameCorners(const std::vector<cv::Point2f>& actual, const std::vector<cv::Point2f>& expected,
+                                  const double tolerance) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (const auto& corner : expected) {
+            double distance = std::numeric_limits<double>::max();
+            for (const auto& candidate : actual) {
+                distance = std::min(distance, cv::norm(candidate - corner));
+            }
+            EXPECT_LE(distance, tolerance) << corner;
+        }
+    }
+};
+
+TEST_F(SheetDetectionTests, TestProxyMatchesFullResolution) {
+    for (const double scale : {1.0, 2.5}) {
+        const std::vector<cv::Mat> frames = getFrames(scale);
+        ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+        subvision::ProcessingContext context;
+        for (const cv::Mat& frame : frames) {
+            SCOPED_TRACE(cv::format("%dx%d", frame.cols, frame.rows));
+            const auto full = subvision::tryGetSheetCoordinates(frame, context);
+            const auto proxy = subvision::tryGetSheetCoordinates(frame, context, subvision::SheetDetectionMode::PROXY);
+            ASSERT_TRUE(full.has_value());
+            ASSERT_TRUE(proxy.has_value());
+
+            // Les coins en pourcentage sont comparés en pixels de l'image d'origine
+            const double tolerance = 0.003 * std::max(frame.cols, frame.rows);
+            expectSameCorners(subvision::percentageToCoordinates(*proxy, frame.cols, frame.rows),
+                              subvision::percentageToCoordinates(*full, frame.cols, frame.rows), tolerance);
+        }
+    }
+}
+
+TEST_F(SheetDetectionTests, TestProxyYuvMatchesBgr) {
+    const std::vector<cv::Mat> frames = getFrames(2.5);
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    subvision::ProcessingContext context;
+    for (const cv::Mat& frame : frames) {
+        cv::Mat i420;
+        cv::cvtColor(frame, i420, cv::COLOR_BGR2YUV_I420);
+        const subvision::ImageBuffer image = subvision::makeContiguousYuvImageBuffer(
+            subvision::PixelFormat::I420, frame.cols, frame.rows, i420.data);
+
+        const auto expected = subvision::tryGetSheetCoordinates(frame, context);
+        const auto corners = subvision::tryGetSheetCoordinates(image, context, subvision::SheetDetectionMode::PROXY);
+        ASSERT_TRUE(expected.has_value());
+        ASSERT_TRUE(corners.has_value());
+        const double tolerance = 0.003 * std::max(frame.cols, frame.rows);
+        expectSameCorners(subvision::percentageToCoordinates(*corners, frame.cols, frame.rows),
+                          subvision::percentageToCoordinates(*expected, frame.cols, frame.rows), tolerance);
+    }
+}
+
+TEST_F(SheetDetectionTests, TestProxySheetPicture) {
+    const std::vector<cv::Mat> frames = getFrames(1.0);
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    subvision::ProcessingContext context;
+    const auto sheet = subvision::tryGetSheetPicture(frames.front(), context, subvision::SheetDetectionMode::PROXY);
+    ASSERT_TRUE(sheet.has_value());
+    EXPECT_EQ(sheet->size(), cv::Size(2000, 2000));
+
+    // Photo noire : pas de feuille, même erreur qu'à pleine résolution
+    const auto none = subvision::tryGetSheetCoordinates(cv::Mat(600, 800, CV_8UC3, cv::Scalar(0, 0, 0)), context,
+                                                        subvision::SheetDetectionMode::PROXY);
+    ASSERT_FALSE(none.has_value());
+    EXPECT_EQ(none.error().code, subvision::ErrorCode::NO_SHEET);
+}
+
+TEST_F(SheetDetectionTests, TestWarpSheetZoneMatchesSheetCrop) {
+    const std::vector<cv::Mat> frames = getFrames(2.5);
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const cv::Mat& frame = frames.front();
+    const std::vector<cv::Point2f> corners = subvision::percentageToCoordinates(
+        subvision::getSheetCoordinates(frame), frame.cols, frame.rows);
+    const cv::Mat transform = subvision::getSheetTransform(corners);
+    const cv::Mat sheet = subvision::warpSheet(frame, corners);
+
+    for (const int zone : subvision::TARGET_ZONES) {
+        SCOPED_TRACE(zone);
+        const cv::Mat expected = subvision::getTargetView(sheet, zone);
+
+        // Même échantillonnage que la feuille complète
+        cv::Mat tile;
+        subvision::warpSheetZone(frame, transform, zone, 1.0, tile);
+        ASSERT_EQ(tile.size(), expected.size());
+        EXPECT_LE(cv::norm(tile, expected, cv::NORM_INF), 1);
+
+        // Tuile réduite proche de la zone de la feuille réduite
+        subvision::warpSheetZone(frame, transform, zone, 0.25, tile);
+        cv::Mat reduced;
+        cv::resize(expected, reduced, cv::Size(expected.cols / 4, expected.rows / 4), 0, 0, cv::INTER_LINEAR);
+        ASSERT_EQ(tile.size(), reduced.size());
+        EXPECT_LE(cv::norm(tile, reduced, cv::NORM_L1) / static_cast<double>(tile.total() * tile.channels()), 2.0);
+    }
+}
+
+TEST_F(SheetDetectionTests, TestWarpSheetZoneFollowsResolutionProfile) {
+    const std::vector<cv::Mat> frames = getFrames(2.5);
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const cv::Mat& frame = frames.front();
+    const std::vector<cv::Point2f> corners = subvision::percentageToCoordinates(
+        subvision::getSheetCoordinates(frame), frame.cols, frame.rows);
+
+    for (const auto resolution : {subvision::ResolutionProfile::FAST, subvision::ResolutionProfile::BALANCED}) {
+        const int side = subvision::getProcessingProfile(resolution).sheetSize;
+        const auto transform = subvision::tryGetSheetTransform(corners, cv::Size(side, side));
+        ASSERT_TRUE(transform.has_value());
+        cv::Mat sheet;
+        ASSERT_TRUE(subvision::tryWarpSheet(frame, corners, sheet, resolution).has_value());
+        ASSERT_EQ(sheet.size(), cv::Size(side, side));
+
+        // Tuile de la zone de la feuille du profil, pas de la feuille de référence
+        for (const int zone : subvision::TARGET_ZONES) {
+            SCOPED_TRACE(zone);
+            const cv::Mat expected = subvision::getTargetView(sheet, zone);
+            cv::Mat tile;
+            subvision::warpSheetZone(frame, *transform, zone, 1.0, tile, resolution);
+            ASSERT_EQ(tile.size(), expected.size());
+            EXPECT_LE(cv::norm(tile, expected, cv::NORM_INF), 1);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SUBVISION_CORE_TEST_HELPERS_H
+#define SUBVISION_CORE_TEST_HELPERS_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/types.h"
+
+// Ressources copiées à côté de l'exécutable des tests
+inline const std::string TESTS_RESOURCES_PATH = (std::filesystem::current_path() / "resources").string();
+
+// Feuilles recadrées posées sur un fond sombre, comme sur une photo ou une image de la caméra.
+// offset décale la feuille dans l'image, scale agrandit l'image obtenue
+inline std::vector<cv::Mat> getFrames(const double scale = 1.0, const cv::Point offset = cv::Point()) {
+    std::vector<cv::Mat> frames;
+    for (const auto& entry : std::filesystem::directory_iterator(TESTS_RESOURCES_PATH)) {
+        const std::filesystem::path sheetPath = entry.path() / "cropped_sheet.jpg";
+        if (!entry.is_directory() || !std::filesystem::exists(sheetPath)) {
+            continue;
+        }
+        cv::Mat sheet = cv::imread(sheetPath.string());
+        cv::resize(sheet, sheet, cv::Size(1000, 1000));
+        cv::Mat frame;
+        cv::copyMakeBorder(sheet, frame, 150 + offset.y, 150 - offset.y, 200 + offset.x, 200 - offset.x,
+                           cv::BORDER_CONSTANT, cv::Scalar(40, 40, 40));
+        if (scale != 1.0) {
+            cv::resize(frame, frame, cv::Size(), scale, scale);
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+// Mêmes scores et mêmes zones, dans le même ordre
+inline void expectSameScores(const subvision::ImpactResults& actual, const subvision::ImpactResults& expected) {
+    ASSERT_EQ(actual.impacts.size(), expected.impacts.size());
+    for (std::size_t i = 0; i < expected.impacts.size(); ++i) {
+        ASSERT_EQ(actual.impacts[i].score, expected.impacts[i].score);
+        ASSERT_EQ(actual.impacts[i].zone, expected.impacts[i].zone);
+    }
+}
+
+// Impacts identiques au bit près
+inline void expectSameImpacts(const std::vector<subvision::Impact>& actual,
+                              const std::vector<subvision::Impact>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].distance, expected[i].distance);
+        EXPECT_EQ(actual[i].score, expected[i].score);
+        EXPECT_EQ(actual[i].zone, expected[i].zone);
+        EXPECT_EQ(actual[i].angle, expected[i].angle);
+    }
+}
+
+// Impacts, cibles et image annotée identiques
+inline void expectSameResults(const subvision::ImpactResults& actual, const subvision::ImpactResults& expected) {
+    expectSameImpacts(actual.impacts, expected.impacts);
+    ASSERT_EQ(actual.targets.size(), expected.targets.size());
+    for (const auto& entry : expected.targets) {
+        const subvision::Ellipse& ellipse = actual.targets.at(entry.first);
+        EXPECT_EQ(ellipse.center(), entry.second.center());
+        EXPECT_EQ(ellipse.axes(), entry.second.axes());
+        EXPECT_EQ(ellipse.angle(), entry.second.angle());
+    }
+    EXPECT_EQ(cv::norm(actual.annotatedImage, expected.annotatedImage, cv::NORM_INF), 0);
+}
+
+#endif //SUBVISION_CORE_TEST_HELPERS_H
@@ -0,0 +1,64 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../include/trace.h"
+
+class TracingTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        subvision::Tracer::instance().clear();
+        subvision::Tracer::instance().setEnabled(true);
+    }
+
+    void TearDown() override {
+        subvision::Tracer::instance().setEnabled(false);
+        subvision::Tracer::instance().clear();
+    }
+};
+
+TEST_F(TracingTests, TestNestedScopes) {
+    {
+        subvision::TraceScope outer("outer");
+        {
+            subvision::TraceScope inner("inner");
+        }
+    }
+
+    const std::vector<subvision::TraceEvent> events = subvision::Tracer::instance().events();
+    ASSERT_EQ(events.size(), 2u);
+
+    // Les intervalles sont enregistrés à leur fermeture : l'intervalle interne d'abord
+    ASSERT_EQ(events[0].name, "inner");
+    ASSERT_EQ(events[0].depth, 1);
+    ASSERT_EQ(events[1].name, "outer");
+    ASSERT_EQ(events[1].depth, 0);
+    ASSERT_EQ(events[0].threadId, events[1].threadId);
+    ASSERT_GE(events[0].startMicros, events[1].startMicros);
+    ASSERT_LE(events[0].durationMicros, events[1].durationMicros);
+}
+
+TEST_F(TracingTests, TestDisabledTracerRecordsNothing) {
+    subvision::Tracer::instance().setEnabled(false);
+    {
+        subvision::TraceScope scope("ignored");
+    }
+    ASSERT_TRUE(subvision::Tracer::instance().events().empty());
+}
+
+TEST_F(TracingTests, TestChromeTraceExport) {
+    {
+        subvision::TraceScope scope("getImpactsMask");
+    }
+
+    std::ostringstream chromeTrace;
+    subvision::Tracer::instance().exportChromeTrace(chromeTrace);
+    const std::string trace = chromeTrace.str();
+    ASSERT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    ASSERT_NE(trace.find("\"name\":\"getImpactsMask\""), std::string::npos);
+    ASSERT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+
+    std::ostringstream json;
+    subvision::Tracer::instance().exportJson(json);
+    ASSERT_NE(json.str().find("\"depth\":0"), std::string::npos);
+}
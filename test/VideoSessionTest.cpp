@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <gtest/gtest.h>
+#include "../include/impact_detection.h"
+#include "../include/video_session.h"
+#include "TestHelpers.h"
+
+class VideoSessionTests : public ::testing::Test {
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+};
+
+TEST_F(VideoSessionTests, TestStillFrameIsTrackedAndReusesTargets) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    for (const cv::Mat& frame : frames) {
+        subvision::VideoSession session;
+
+        subvision::ImpactResults first;
+        ASSERT_TRUE(session.processFrame(frame, first));
+        ASSERT_FALSE(session.isTracking());
+        ASSERT_FALSE(session.reusedTargets());
+        const std::vector<cv::Point2f> detectedCorners = session.corners();
+
+        subvision::ImpactResults second;
+        ASSERT_TRUE(session.processFrame(frame, second));
+        ASSERT_TRUE(session.isTracking());
+        ASSERT_TRUE(session.reusedTargets());
+        ASSERT_GT(session.trackingScore(), 0.99f);
+        for (std::size_t i = 0; i < detectedCorners.size(); ++i) {
+            ASSERT_LT(cv::norm(session.corners()[i] - detectedCorners[i]), 0.75);
+        }
+        expectSameScores(second, first);
+
+        subvision::ImpactResults reference;
+        ASSERT_TRUE(subvision::retrieveImpacts(frame, reference));
+        expectSameScores(first, reference);
+    }
+    std::cout << "Video Session: Tested " << frames.size() << " still frames" << std::endl;
+}
+
+TEST_F(VideoSessionTests, TestShiftedFrameIsTracked) {
+    const std::vector<cv::Mat> frames = getFrames();
+    ASSERT_FALSE(frames.empty()) << "No cropped_sheet.jpg found in " << TESTS_RESOURCES_PATH;
+
+    const cv::Point2f shift(7, -5);
+    for (const cv::Mat& frame : frames) {
+        const cv::Mat translation = (cv::Mat_<double>(2, 3) << 1, 0, shift.x, 0, 1, shift.y);
+        cv::Mat shifted;
+        cv::warpAffine(frame, shifted, translation, frame.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+
+        subvision::VideoSession session;
+        subvision::ImpactResults first;
+        ASSERT_TRUE(session.processFrame(frame, first));
+        const std::vector<cv::Point2f> detectedCorners = session.corners();
+
+        // Le déplacement dépasse le seuil de réutilisation : les cibles sont recalculées
+        subvision::ImpactResults second;
+        ASSERT_TRUE(session.processFrame(shifted, second));
+        ASSERT_TRUE(session.isTracking());
+        ASSERT_FALSE(session.reusedTargets());
+        for (std::size_t i = 0; i < detectedCorners.size(); ++i) {
+            ASSERT_LT(cv::norm(session.corners()[i] - (detectedCorners[i] + shift)), 1.0);
+        }
+        ASSERT_EQ(second.impacts.size(), first.impacts.size());
+
+        session.reset();
+        subvision::ImpactResults third;
+        ASSERT_TRUE(session.processFrame(shifted, third));
+        ASSERT_FALSE(session.isTracking());
+    }
+}
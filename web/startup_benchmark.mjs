@@ -0,0 +1,157 @@
+// Mesure du démarrage à froid des modules WASM sous Node (make benchmark_startup) : taille téléchargée,
+// compilation et instanciation du .wasm, initialisation du runtime puis latence du premier processTargetImage.
+// Chaque mesure est faite dans un nouveau processus Node, sans cache de compilation partagé.
+// Usage : node build_wasm/startup_benchmark.mjs [--runs N] module.js [module.js ...]
+import {spawnSync} from 'node:child_process';
+import {existsSync, readFileSync} from 'node:fs';
+import {createRequire} from 'node:module';
+import {basename, dirname, join, resolve} from 'node:path';
+import {fileURLToPath} from 'node:url';
+import {brotliCompressSync, gzipSync} from 'node:zlib';
+import {createFrame, HEIGHT, WIDTH} from './synthetic_frame.mjs';
+
+const require = createRequire(import.meta.url);
+const here = dirname(fileURLToPath(import.meta.url));
+const DEFAULT_MODULES = ['subvision_node.js', 'subvision_slim.js'];
+const DEFAULT_RUNS = 5;
+
+function getWasmPath(modulePath) {
+    return modulePath.replace(/\.js$/, '.wasm');
+}
+
+// Tailles brutes et compressées (gzip, brotli) du .js et du .wasm, en octets
+function measureSizes(modulePath) {
+    const files = [modulePath, getWasmPath(modulePath)].filter((path) => existsSync(path));
+    const sizes = {raw: 0, gzip: 0, brotli: 0};
+    for (const path of files) {
+        const bytes = readFileSync(path);
+        sizes.raw += bytes.length;
+        sizes.gzip += gzipSync(bytes, {level: 9}).length;
+        sizes.brotli += brotliCompressSync(bytes).length;
+    }
+    return sizes;
+}
+
+// Un démarrage à froid, dans le processus enfant. Temps en millisecondes
+async function measureColdStart(modulePath) {
+    const start = performance.now();
+    const bytes = readFileSync(getWasmPath(modulePath));
+    const compileStart = performance.now();
+    const compiled = await WebAssembly.compile(bytes);
+    const compileEnd = performance.now();
+
+    let instantiateEnd = 0;
+    const factory = require(modulePath);
+    const module = await factory({
+        // Instanciation du module déjà compilé, pour séparer compilation, instanciation et initialisation
+        instantiateWasm(imports, receiveInstance) {
+            WebAssembly.instantiate(compiled, imports).then((instance) => {
+                instantiateEnd = performance.now();
+                receiveInstance(instance, compiled);
+            });
+            return {};
+        }
+    });
+    const ready = performance.now();
+
+    const pixels = createFrame();
+    const callStart = performance.now();
+    const results = module.processTargetImage(WIDTH, HEIGHT, pixels);
+    const firstCall = performance.now() - callStart;
+    const impacts = results.impacts.length;
+    results.annotatedImage.delete();
+
+    const secondStart = performance.now();
+    module.processTargetImage(WIDTH, HEIGHT, pixels).annotatedImage.delete();
+    const secondCall = performance.now() - secondStart;
+
+    return {
+        read: compileStart - start,
+        compile: compileEnd - compileStart,
+        instantiate: instantiateEnd - compileEnd,
+        runtime: ready - instantiateEnd,
+        firstCall,
+        secondCall,
+        total: ready - start + firstCall,
+        impacts
+    };
+}
+
+function median(values) {
+    const sorted = [...values].sort((a, b) => a - b);
+    const middle = Math.floor(sorted.length / 2);
+    return sorted.length % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+function runChild(modulePath) {
+    const child = spawnSync(process.execPath, [fileURLToPath(import.meta.url), '--child', modulePath],
+        {encoding: 'utf8'});
+    if (child.status !== 0) {
+        throw new Error(`${basename(modulePath)}: ${child.stderr.trim()}`);
+    }
+    return JSON.parse(child.stdout.trim().split('\n').pop());
+}
+
+function parseArguments(args) {
+    let runs = DEFAULT_RUNS;
+    const modules = [];
+    for (let i = 0; i < args.length; ++i) {
+        if (args[i] === '--runs') {
+            runs = Math.max(1, parseInt(args[++i], 10));
+        } else {
+            modules.push(resolve(args[i]));
+        }
+    }
+    if (modules.length === 0) {
+        modules.push(...DEFAULT_MODULES.map((name) => join(here, name)).filter((path) => existsSync(path)));
+    }
+    return {runs, modules};
+}
+
+function formatKiB(bytes) {
+    return `${(bytes / 1024).toFixed(0)} KiB`;
+}
+
+async function main() {
+    const args = process.argv.slice(2);
+    if (args[0] === '--child') {
+        console.log(JSON.stringify(await measureColdStart(resolve(args[1]))));
+        return;
+    }
+
+    const {runs, modules} = parseArguments(args);
+    if (modules.length === 0) {
+        throw new Error('No module found, build subvision_slim and subvision_node first');
+    }
+
+    const rows = [];
+    for (const modulePath of modules) {
+        const samples = [];
+        for (let i = 0; i < runs; ++i) {
+            samples.push(runChild(modulePath));
+        }
+        const timing = (key) => `${median(samples.map((sample) => sample[key])).toFixed(1)} ms`;
+        const sizes = measureSizes(modulePath);
+        rows.push({
+            module: basename(modulePath),
+            raw: formatKiB(sizes.raw),
+            gzip: formatKiB(sizes.gzip),
+            brotli: formatKiB(sizes.brotli),
+            compile: timing('compile'),
+            instantiate: timing('instantiate'),
+            runtime: timing('runtime'),
+            firstCall: timing('firstCall'),
+            secondCall: timing('secondCall'),
+            total: timing('total'),
+            impacts: samples[0].impacts
+        });
+    }
+
+    console.log(`Node ${process.version}, median of ${runs} cold starts, frame ${WIDTH}x${HEIGHT} RGBA`);
+    console.table(rows);
+}
+
+main().catch((error) => {
+    console.error(error);
+    process.exit(1);
+});
@@ -0,0 +1,52 @@
+// Image synthétique RGBA partagée par les scripts Node (verify_mt.mjs, startup_benchmark.mjs) : fond sombre,
+// feuille claire, cinq cibles noires aux centres des zones, deux impacts rouges par cible
+export const WIDTH = 1400;
+export const HEIGHT = 1300;
+export const SHEET_X = 200;
+export const SHEET_Y = 150;
+export const SHEET_SIZE = 1000;
+export const TARGET_RADIUS = 84;
+export const RING_RADII = [28, 56];
+export const IMPACT_RADIUS = 5;
+export const IMPACT_OFFSETS = [[20, 10], [-45, 30]];
+export const TARGET_CENTERS = [[250, 250], [750, 250], [250, 750], [750, 750], [500, 500]];
+
+export function createFrame() {
+    const pixels = new Uint8Array(WIDTH * HEIGHT * 4);
+    const setPixel = (x, y, value) => {
+        const offset = (y * WIDTH + x) * 4;
+        pixels.set(value, offset);
+    };
+
+    for (let y = 0; y < HEIGHT; ++y) {
+        for (let x = 0; x < WIDTH; ++x) {
+            const inSheet = x >= SHEET_X && x < SHEET_X + SHEET_SIZE && y >= SHEET_Y && y < SHEET_Y + SHEET_SIZE;
+            setPixel(x, y, inSheet ? [220, 220, 220, 255] : [40, 40, 40, 255]);
+        }
+    }
+
+    for (const [targetX, targetY] of TARGET_CENTERS) {
+        const cx = SHEET_X + targetX;
+        const cy = SHEET_Y + targetY;
+        for (let y = cy - TARGET_RADIUS; y <= cy + TARGET_RADIUS; ++y) {
+            for (let x = cx - TARGET_RADIUS; x <= cx + TARGET_RADIUS; ++x) {
+                const distance = Math.hypot(x - cx, y - cy);
+                if (distance > TARGET_RADIUS) {
+                    continue;
+                }
+                const onRing = RING_RADII.some((radius) => Math.abs(distance - radius) <= 1.5);
+                setPixel(x, y, onRing ? [220, 220, 220, 255] : [0, 0, 0, 255]);
+            }
+        }
+        for (const [dx, dy] of IMPACT_OFFSETS) {
+            for (let y = cy + dy - IMPACT_RADIUS; y <= cy + dy + IMPACT_RADIUS; ++y) {
+                for (let x = cx + dx - IMPACT_RADIUS; x <= cx + dx + IMPACT_RADIUS; ++x) {
+                    if (Math.hypot(x - cx - dx, y - cy - dy) <= IMPACT_RADIUS) {
+                        setPixel(x, y, [255, 0, 0, 255]);
+                    }
+                }
+            }
+        }
+    }
+    return pixels;
+}
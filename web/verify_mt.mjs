@@ -0,0 +1,69 @@
+// Vérification de la variante multithread (make subvision_mt) sous Node, les pthreads
+// s'exécutent sur des worker_threads. Usage : node build_wasm/verify_mt.mjs
+import {createRequire} from 'node:module';
+import {dirname, join} from 'node:path';
+import {fileURLToPath} from 'node:url';
+import {
+    createFrame, HEIGHT, IMPACT_OFFSETS, SHEET_SIZE, SHEET_X, SHEET_Y, TARGET_CENTERS, WIDTH
+} from './synthetic_frame.mjs';
+
+const require = createRequire(import.meta.url);
+const here = dirname(fileURLToPath(import.meta.url));
+
+function check(condition, message) {
+    if (!condition) {
+        throw new Error(message);
+    }
+}
+
+function processFrame(module, pixels) {
+    const buffer = new module.ImageBuffer(WIDTH, HEIGHT, module.PixelFormat.RGBA);
+    try {
+        buffer.data().set(pixels);
+        const corners = module.getImageBufferSheetCoordinates(buffer);
+        const start = performance.now();
+        const results = module.processImageBuffer(buffer);
+        const elapsed = performance.now() - start;
+        results.annotatedImage.delete();
+        return {corners, impacts: results.impacts, elapsed};
+    } finally {
+        buffer.delete();
+    }
+}
+
+async function main() {
+    const pixels = createFrame();
+    const Subvision = require(join(here, 'subvision_mt.js'));
+    const module = await Subvision();
+
+    const threads = module.getThreadCount();
+    console.log(`Zone workers: ${threads}`);
+    check(threads > 1, 'The pthreads build must process the zones on several workers');
+
+    const result = processFrame(module, pixels);
+    const expectedCorners = [
+        [SHEET_X, SHEET_Y], [SHEET_X + SHEET_SIZE, SHEET_Y],
+        [SHEET_X + SHEET_SIZE, SHEET_Y + SHEET_SIZE], [SHEET_X, SHEET_Y + SHEET_SIZE]
+    ];
+    check(result.corners.length === 4, 'The sheet must have 4 corners');
+    for (const [x, y] of expectedCorners) {
+        const distance = Math.min(...result.corners.map((corner) =>
+            Math.hypot(corner.x * WIDTH - x, corner.y * HEIGHT - y)));
+        check(distance < 3, `No sheet corner found near (${x}, ${y})`);
+    }
+
+    const expectedImpacts = TARGET_CENTERS.length * IMPACT_OFFSETS.length;
+    check(result.impacts.length === expectedImpacts,
+        `Expected ${expectedImpacts} impacts, got ${result.impacts.length}`);
+    console.log(`processImageBuffer: ${result.impacts.length} impacts in ${result.elapsed.toFixed(1)} ms`);
+
+    console.log('OK');
+}
+
+main().then(() => {
+    // Les workers du pool maintiennent le processus en vie
+    process.exit(0);
+}, (error) => {
+    console.error(error);
+    process.exit(1);
+});